@@ -0,0 +1,80 @@
+#include "AsyncWorker.h"
+
+AsyncWorker::AsyncWorker(JobFunction function, void* context) :
+	myFunction(function),
+	myContext(context),
+	myBusy(false),
+	myPublished(-1),
+	myPendingSlot(-1),
+	myStopping(false)
+{
+	myThread = std::thread(&AsyncWorker::workerLoop, this);
+}
+
+AsyncWorker::~AsyncWorker()
+{
+	{
+		std::lock_guard<std::mutex> lock(myMutex);
+		myStopping = true;
+	}
+
+	myWakeUp.notify_one();
+	myThread.join();
+}
+
+bool
+AsyncWorker::start()
+{
+	if (myBusy.load(std::memory_order_acquire))
+		return false;
+
+	myBusy.store(true, std::memory_order_relaxed);
+
+	{
+		std::lock_guard<std::mutex> lock(myMutex);
+		myPendingSlot = myPublished.load(std::memory_order_relaxed) == 0 ? 1 : 0;
+	}
+
+	myWakeUp.notify_one();
+	return true;
+}
+
+bool
+AsyncWorker::isBusy() const
+{
+	return myBusy.load(std::memory_order_acquire);
+}
+
+int32_t
+AsyncWorker::getPublished() const
+{
+	return myPublished.load(std::memory_order_acquire);
+}
+
+void
+AsyncWorker::workerLoop()
+{
+	for (;;)
+	{
+		int32_t slot;
+
+		{
+			std::unique_lock<std::mutex> lock(myMutex);
+			myWakeUp.wait(lock, [this] { return myStopping || myPendingSlot >= 0; });
+
+			// a job started before the node went away still runs
+			if (myPendingSlot < 0)
+				return;
+
+			slot = myPendingSlot;
+			myPendingSlot = -1;
+		}
+
+		myFunction(myContext, slot);
+
+		// the result is written before it is published, and published before
+		// the cook thread can start the next job
+		myPublished.store(slot, std::memory_order_release);
+		myBusy.store(false, std::memory_order_release);
+	}
+}
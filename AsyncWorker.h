@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// A thread that runs one job at a time for the cook thread, which never waits
+// for it. A job writes its result in one of two slots, the one that wasn't
+// published last, and publishes it when done. The cook thread reads the
+// published slot while the next job writes the other one.
+class AsyncWorker
+{
+public:
+
+	// Called on the worker thread with the slot, 0 or 1, to write the result in
+	typedef void	(*JobFunction)(void* context, int32_t slot);
+
+	AsyncWorker(JobFunction function, void* context);
+
+	// Waits for the running job to end
+	~AsyncWorker();
+
+	// Starts a job, unless one is running. Returns false if one is.
+	bool		start();
+
+	// True from start() until the job has published its slot. While it is
+	// false, nothing the job reads or writes is used by the worker thread.
+	bool		isBusy() const;
+
+	// Slot of the last finished job, -1 before the first one. It can be
+	// read until start() is called again.
+	int32_t		getPublished() const;
+
+private:
+
+	void		workerLoop();
+
+	JobFunction				myFunction;
+	void*					myContext;
+
+	std::atomic<bool>		myBusy;
+	std::atomic<int32_t>	myPublished;
+
+	// the slot of the job start() hands over, -1 when there is none
+	std::mutex				myMutex;
+	std::condition_variable	myWakeUp;
+	int32_t					myPendingSlot;
+	bool					myStopping;
+
+	std::thread				myThread;
+};
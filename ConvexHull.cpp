@@ -13,11 +13,154 @@
 */
 
 #include "ConvexHull.h"
+#include "PointKernels.h"
+#include "ThreadPool.h"
 
 #include <stdio.h>
 #include <string.h>
 #include <math.h>
 #include <assert.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+// Below this many points per thread a parallel build is slower than a serial one
+static const int32_t MinPointsPerThread = 50000;
+
+// Points the bounded hull tests between two looks at the clock
+static const int32_t BoundedScanBlock = 65536;
+
+// A cook counts as small for the trim policy when its input is at most this
+// fraction of the largest input the scratch has grown to
+static const int32_t SmallCookRatio = 4;
+
+typedef CookTrace::Clock CookClock;
+
+static float
+millisecondsSince(CookClock::time_point start)
+{
+	return std::chrono::duration<float, std::milli>(CookClock::now() - start).count();
+}
+
+// Copies a hull built with original indices over 'points' into 'outPoints',
+// 'outIndices' and 'outSources'. The index buffer points into 'points', it is
+// compacted to the vertices actually used, in order of first use like quickhull
+// does, and narrowed to the int32_t the SOP wants. 'sourceIndices' maps
+// 'points' to the input points, nullptr when 'points' is the input itself.
+// 'remap' is scratch that must be filled with -1, it is left that way.
+template<typename T>
+static void
+compactHull(const quickhull::ConvexHull<T>& hull, const Position* points,
+			const int32_t* sourceIndices, CountedVector<int32_t>& remap,
+			CountedVector<Position>& outPoints, CountedVector<int32_t>& outIndices,
+			CountedVector<int32_t>& outSources)
+{
+	outPoints.clear();
+	outIndices.clear();
+	outSources.clear();
+
+	const auto& indexBuffer = hull.getIndexBuffer();
+
+	if (remap.size() < hull.getVertexBuffer().size())
+		remap.resize(hull.getVertexBuffer().size(), -1);
+
+	outIndices.resize(indexBuffer.size());
+
+	for (size_t i = 0; i < indexBuffer.size(); i++)
+	{
+		size_t source = indexBuffer[i];
+		int32_t& remapped = remap[source];
+
+		if (remapped < 0)
+		{
+			remapped = static_cast<int32_t>(outPoints.size());
+			outPoints.push_back(points[source]);
+			outSources.push_back(sourceIndices ? sourceIndices[source] : static_cast<int32_t>(source));
+		}
+
+		outIndices[i] = remapped;
+	}
+
+	// reset only the entries we touched, the table is as big as the input
+	for (size_t source : indexBuffer)
+	{
+		remap[source] = -1;
+	}
+}
+
+// Gathers values of a point attribute made of float structs (Vector, Color,
+// TexCoord), 'numPerPoint' structs per point
+template<typename T>
+static void
+gatherPoints(const T* values, int32_t numPerPoint, const int32_t* sources, int32_t count, T* out)
+{
+	PointKernels::gather(reinterpret_cast<const float*>(values),
+	                     static_cast<int32_t>(numPerPoint * sizeof(T) / sizeof(float)),
+	                     sources, count, reinterpret_cast<float*>(out));
+}
+
+// Bounding box of 'numPoints' points, at least one
+static BoundingBox
+boundsOf(const Position* points, int32_t numPoints)
+{
+	BoundingBox bbox(points[0], points[0]);
+
+	for (int32_t i = 1; i < numPoints; i++)
+	{
+		bbox.enlargeBounds(points[i]);
+	}
+
+	return bbox;
+}
+
+// The attributes of the input that can follow the hull points, nullptr when
+// missing. Only point attributes can, vertex and primitive ones have no
+// value per input point.
+static const SOP_NormalInfo*
+getPointNormals(const OP_SOPInput* sinput)
+{
+	const SOP_NormalInfo* info = sinput->getNormals();
+
+	if (!info || info->attribSet != AttribSet::Point || info->numNormals < sinput->getNumPoints())
+		return nullptr;
+
+	return info;
+}
+
+static const SOP_ColorInfo*
+getPointColors(const OP_SOPInput* sinput)
+{
+	const SOP_ColorInfo* info = sinput->getColors();
+
+	if (!info || info->attribSet != AttribSet::Point || info->numColors < sinput->getNumPoints())
+		return nullptr;
+
+	return info;
+}
+
+static const SOP_TextureInfo*
+getPointTextures(const OP_SOPInput* sinput)
+{
+	const SOP_TextureInfo* info = sinput->getTextures();
+
+	if (!info || info->attribSet != AttribSet::Point || info->numTextureLayers <= 0 ||
+	    info->numTextures < sinput->getNumPoints())
+		return nullptr;
+
+	return info;
+}
+
+static int32_t
+findRoot(CountedVector<int32_t>& parents, int32_t i)
+{
+	while (parents[i] != i)
+	{
+		parents[i] = parents[parents[i]];
+		i = parents[i];
+	}
+	return i;
+}
 
 // These functions are basic C function, which the DLL loader can find
 // much easier than finding a C++ Class.
@@ -76,14 +219,48 @@ extern "C"
 };
 
 
-ConvexHull::ConvexHull(const OP_NodeInfo* info) : myNodeInfo(info)
+ConvexHull::ConvexHull(const OP_NodeInfo* info) : myNodeInfo(info),
+	myPrecision(Precision::Float),
+	myTagInput(false),
+	myCcw(false),
+	myLastVBOFrame(-2),
+	myCacheValid(false),
+	myCacheHits(0),
+	myCacheMisses(0),
+	myWarmNumPoints(0),
+	myWarmStarts(0),
+	myWarmFallbacks(0),
+	myCulledPoints(0),
+	myNumThreads(1),
+	myPlanar(false),
+	myApproxError(0.0f),
+	myBudgetExpired(false),
+	myDeadline(CookClock::time_point::max()),
+	myFetchMs(0.0f),
+	myBuildMs(0.0f),
+	myEmitMs(0.0f),
+	myInputPoints(0),
+	myEngine("none"),
+	myLargestInput(0),
+	mySmallCooks(0),
+	myMemoryReleases(0),
+	myKeptBytes(0),
+	myKeptCap(0.0),
+	myKeptPoints(0),
+	myAsyncFrame(0),
+	myAsyncSubmitted(false),
+	myAsyncSequence(0),
+	myAsyncTaken(0),
+	myAsyncTakenFrame(0),
+	myAsyncAge(0)
 {
 
 }
 
 ConvexHull::~ConvexHull()
 {
-	 
+	// the running job uses the builder and the result slots
+	myAsyncWorker.reset();
 }
 
 void
@@ -92,151 +269,2804 @@ ConvexHull::getGeneralInfo(SOP_GeneralInfo* ginfo, const OP_Inputs* inputs, void
 	// This will cause the node to cook every frame
 	ginfo->cookEveryFrameIfAsked = false;
 
-	//if direct to GPU loading:
-	ginfo->directToGPU = false;
+	// the hulls the worker finishes are only output when the node cooks, even
+	// if nothing upstream changed
+	ginfo->cookEveryFrame = inputs->getParInt("Async") ? true : false;
+
+	// load the hull straight into VBOs when it is only used for rendering,
+	// in that case executeVBO() is called instead of execute()
+	ginfo->directToGPU = inputs->getParInt("Directtogpu") ? true : false;
 }
 
 void
-ConvexHull::execute(SOP_Output* output, const OP_Inputs* inputs, void* reserved)
+ConvexHull::readSettings(const OP_Inputs* inputs, HullSettings& settings) const
+{
+	settings.epsilon = static_cast<float>(inputs->getParDouble("Epsilon"));
+
+	// triangle vertex order
+	settings.ccw = static_cast<bool>(inputs->getParInt("Ccw"));
+
+	settings.splitBy = static_cast<SplitBy>(inputs->getParInt("Splitby"));
+
+	const char* splitAttrib = inputs->getParString("Splitattrib");
+	settings.splitAttrib = splitAttrib ? splitAttrib : "";
+
+	settings.dimension = static_cast<HullDimension>(inputs->getParInt("Dimension"));
+	settings.plane = static_cast<HullPlane>(inputs->getParInt("Plane"));
+	settings.planarOutput = static_cast<PlanarOutput>(inputs->getParInt("Planaroutput"));
+
+	settings.precision = static_cast<Precision>(inputs->getParInt("Precision"));
+
+	// the VBOs always get the hull mesh
+	settings.tagInput = static_cast<OutputMode>(inputs->getParInt("Output")) == OutputMode::TagInput &&
+	                    !inputs->getParInt("Directtogpu");
+
+	// a closed triangle mesh with V vertices has at most 2V - 4 faces
+	int32_t maxVertices = inputs->getParInt("Maxvertices");
+	int32_t maxFaces = inputs->getParInt("Maxfaces");
+
+	if (maxFaces > 0)
+	{
+		int32_t facesVertices = std::max(maxFaces / 2 + 2, 4);
+		maxVertices = maxVertices > 0 ? std::min(maxVertices, facesVertices) : facesVertices;
+	}
+
+	settings.maxVertices = maxVertices;
+	settings.timeBudget = static_cast<float>(inputs->getParDouble("Timebudget"));
+
+	settings.cache = inputs->getParInt("Cache") ? true : false;
+	settings.threads = inputs->getParInt("Threads");
+	settings.warmStart = inputs->getParInt("Warmstart") ? true : false;
+	settings.warmThreshold = inputs->getParDouble("Warmthreshold");
+	settings.prefilter = inputs->getParInt("Prefilter") ? true : false;
+}
+
+bool
+ConvexHull::updateHull(const OP_Inputs* inputs)
+{
+	if (inputs->getParInt("Async"))
+		return asyncHull(inputs);
+
+	myAsyncAge = 0;
+
+	readSettings(inputs, mySettings);
+
+	return computeHull(mySettings, inputs->getNumInputs() > 0 ? inputs->getInputSOP(0) : nullptr);
+}
+
+bool
+ConvexHull::computeHull(const HullSettings& settings, const OP_SOPInput* sinput)
 {
+	CookClock::time_point fetchStart = CookClock::now();
 
-	if (inputs->getNumInputs() > 0)
+	myFetchMs = 0.0f;
+	myInputPoints = 0;
+	myEngine = "none";
+
+	if (!sinput || sinput->getNumPoints() == 0)
 	{
+		myWarning.clear();
+		clearHull();
+		return false;
+	}
 
-		// get the first input
-		const OP_SOPInput	*sinput = inputs->getInputSOP(0);
+	// get the position of the points from the sop connected to the first input
+	const Position* ptArr = sinput->getPointPositions();
 
-		// get the position of the points from the sop connected to the first input
-		const Position* ptArr = sinput->getPointPositions();
+	float epsilon = settings.epsilon;
+	bool ccw = settings.ccw;
 
-		// convert the position;s pointer to a float pointer as that's what
-		// the getConvexHull function need
-		const float* positions = reinterpret_cast<const float*>(ptArr);
+	SplitBy splitBy = settings.splitBy;
+	const char* splitAttrib = settings.splitAttrib.c_str();
 
-		// get epsilon value
-		float epsilon = static_cast<float>(inputs->getParDouble("Epsilon"));
+	HullDimension dimension = settings.dimension;
+	HullPlane plane = settings.plane;
+	PlanarOutput planarOutput = settings.planarOutput;
 
-		// get triangle vertex order
-		bool ccw = static_cast<bool>(inputs->getParInt("Ccw"));
+	Precision precision = settings.precision;
+	bool tagInput = settings.tagInput;
+	int32_t maxVertices = settings.maxVertices;
+	float timeBudget = settings.timeBudget;
 
-		// generate the convex hull
-	    quickhull::ConvexHull<float> hull = qh.getConvexHull(positions,
-		                                                    sinput->getNumPoints(),
-			                                                ccw,
-		                                                    false,
-			                                                epsilon);
+	// the node also cooks when only a downstream parameter changed, in that case
+	// the input points are the same and the last hull can be output again
+	HullCacheKey key;
+	key.numPoints = sinput->getNumPoints();
+	key.hash = PointKernels::hashPositions(ptArr, key.numPoints);
+	key.epsilon = epsilon;
+	key.ccw = ccw;
+	key.splitBy = splitBy;
+	key.splitHash = hashSplit(sinput, splitBy, splitAttrib);
+	key.dimension = dimension;
+	key.plane = plane;
+	key.planarOutput = planarOutput;
+	key.maxVertices = maxVertices;
+	key.precision = precision;
+	key.tagInput = tagInput;
 
-		
-		// get the points from the convexHull geo and add them to the SOP
-		const auto& vertexBuffer = hull.getVertexBuffer();
-		
-		for (auto& point : vertexBuffer) {
-			output->addPoint(Position(point.x, point.y, point.z));
-		}
+	myInputPoints = key.numPoints;
+	myFetchMs = millisecondsSince(fetchStart);
 
-		// get the indexex from the convexHull and create the triangles on the sop
-		const auto& indexBuffer = hull.getIndexBuffer();
+	if (myTrace.isOpen())
+	{
+		char args[64];
+		snprintf(args, sizeof(args), "\"points\": %d", key.numPoints);
+		myTrace.addSpan("fetch", fetchStart, args);
+	}
 
-		for (size_t i = 0; i < indexBuffer.size() / 3; i++)
-		{
+	if (settings.cache && myCacheValid && key == myCacheKey)
+	{
+		myCacheHits++;
+		myEngine = "cache";
 
-			size_t triangleFirstIndice = i * 3;
+		// myWarning is still the one of the cached hull
+		return !myPoints.empty();
+	}
 
-			// Note: the addTriangle() assumes that the input SOP has triangulated geometry,
-			// if the input geometry is not a triangle, you need to convert it to triangles first:
-			output->addTriangle(indexBuffer[triangleFirstIndice],
-				                indexBuffer[triangleFirstIndice+1],
-				                indexBuffer[triangleFirstIndice+2]);
-		}
+	myWarning.clear();
+	myCacheMisses++;
+	myCacheKey = key;
+	myCacheValid = true;
+	myPrecision = precision;
 
+	// the budget counts from the top of the cook, every path of the build
+	// checks it
+	if (timeBudget > 0.0f)
+	{
+		myDeadline = fetchStart + std::chrono::duration_cast<CookClock::duration>(
+		                              std::chrono::duration<float, std::milli>(timeBudget));
 	}
-	
-}
 
+	// number of threads the hull build can use, 0 means one per core
+	myNumThreads = settings.threads;
 
+	if (myNumThreads <= 0)
+		myNumThreads = std::max(static_cast<int32_t>(std::thread::hardware_concurrency()), 1);
 
-void
-ConvexHull::executeVBO(SOP_VBOOutput* output,
-						const OP_Inputs* inputs,
-						void* reserved)
-{
-	return;
-}
+	if (myNumThreads > 1 && (!myThreadPool || myThreadPool->getNumWorkers() < myNumThreads - 1))
+		myThreadPool.reset(new ThreadPool(myNumThreads - 1));
 
-//-----------------------------------------------------------------------------------------------------
-//								CHOP, DAT, and custom parameters
-//-----------------------------------------------------------------------------------------------------
+	myCulledPoints = 0;
+	myPieceIds.clear();
+	myLineIndices.clear();
+	myPlanar = false;
+	myApproxError = 0.0f;
+	myBudgetExpired = false;
+	myTagInput = tagInput;
+	myCcw = ccw;
 
-int32_t
-ConvexHull::getNumInfoCHOPChans(void* reserved)
-{
-	// We return the number of channel we want to output to any Info CHOP
-	// connected to the CHOP. In this example we are just going to send 4 channels.
-	return 0;
-}
+	if (splitBy != SplitBy::None)
+	{
+		hullPieces(sinput, splitBy, splitAttrib, ccw, epsilon);
 
-void
-ConvexHull::getInfoCHOPChan(int32_t index,
-								OP_InfoCHOPChan* chan, void* reserved)
-{
-	
+		myWarmNumPoints = key.numPoints;
+		myEngine = "pieces";
+
+		endBudget();
+
+		return !myPoints.empty();
+	}
+
+	bool built = false;
+	bool bounded = maxVertices > 0 && maxVertices < key.numPoints;
+
+	// the points extreme along a few directions, found in one pass for the
+	// planar test, the bounded hull and the prefilter
+	int32_t extremes[PointKernels::NumExtremeDirections * 2];
+
+	if (dimension != HullDimension::ThreeD || bounded || settings.prefilter || timeBudget > 0.0f)
+		PointKernels::findExtremePoints(ptArr, key.numPoints, extremes);
+
+	if (dimension != HullDimension::ThreeD)
+	{
+		built = planarHull(ptArr, key.numPoints, extremes, dimension == HullDimension::TwoD,
+		                   plane, planarOutput, ccw, epsilon);
+
+		if (built)
+			myEngine = "planar";
+	}
+
+	// with a time budget the hull grows from the extreme points, the furthest
+	// point of every face first, until it is complete or the deadline passes
+	if (!built && (bounded || timeBudget > 0.0f))
+	{
+		built = boundedHull(ptArr, key.numPoints, extremes, ccw, epsilon,
+		                    bounded ? maxVertices : key.numPoints,
+		                    timeBudget > 0.0f ? &myDeadline : nullptr);
+
+		if (built)
+			myEngine = bounded ? "bounded" : "time budget";
+	}
+
+	// too flat to grow from the extreme points, the complete hull is all
+	// there is
+	if (!built)
+		myDeadline = CookClock::time_point::max();
+
+	if (!built && settings.warmStart)
+	{
+		built = warmStartHull(ptArr, key.numPoints, ccw, epsilon, settings.warmThreshold);
+
+		if (built)
+			myEngine = "warm start";
+	}
+
+	if (!built && settings.prefilter)
+	{
+		built = prefilterHull(ptArr, key.numPoints, extremes, ccw, epsilon);
+
+		if (built)
+			myEngine = "prefilter";
+	}
+
+	if (!built)
+	{
+		// generate the convex hull of all the points
+		hullPoints(ptArr, key.numPoints, nullptr, ccw, epsilon);
+
+		myEngine = "quickhull";
+	}
+
+	endBudget();
+
+	myWarmNumPoints = key.numPoints;
+
+	if (tagInput)
+		computeDepths(ptArr, key.numPoints);
+
+	return !myPoints.empty();
 }
 
 bool
-ConvexHull::getInfoDATSize(OP_InfoDATSize* infoSize, void* reserved)
+ConvexHull::planarHull(const Position* points, int32_t numPoints, const int32_t* extremes,
+						bool force, HullPlane plane, PlanarOutput planarOutput, bool ccw,
+						float epsilon)
 {
-	infoSize->rows = 0;
-	infoSize->cols = 0;
-	// Setting this to false means we'll be assigning values to the table
-	// one row at a time. True means we'll do it one column at a time.
-	infoSize->byColumn = false;
-	return true;
-}
+	TraceSpan span(myTrace, "planar hull");
+	span.addArg("points", numPoints);
 
-void
-ConvexHull::getInfoDATEntries(int32_t index,
-								int32_t nEntries,
-								OP_InfoDATEntries* entries,
-								void* reserved)
-{
+	if (!myPlanarHull.setPlane(points, numPoints, extremes, plane))
+		return false;
 
-}
+	// unless 2D is asked for, only flat input goes to the 2D engine
+	if (!force && !myPlanarHull.isCoplanar(points, numPoints, extremes, epsilon))
+		return false;
 
+	// past the deadline only the extreme points are hulled, they are the
+	// corners of the outline that the scans above already found
+	if (budgetSpent())
+	{
+		myCandidateSources.assign(extremes, extremes + PointKernels::NumExtremeDirections * 2);
+		std::sort(myCandidateSources.begin(), myCandidateSources.end());
+		myCandidateSources.erase(std::unique(myCandidateSources.begin(), myCandidateSources.end()),
+		                         myCandidateSources.end());
 
+		mySubsetPoints.resize(myCandidateSources.size());
 
-void
-ConvexHull::setupParameters(OP_ParameterManager* manager, void* reserved)
-{
-	// Epsilon
-	{
-		OP_NumericParameter	np;
+		for (size_t i = 0; i < myCandidateSources.size(); i++)
+		{
+			mySubsetPoints[i] = points[myCandidateSources[i]];
+		}
 
-		np.name = "Epsilon";
-		np.label = "Epsilon";
-		np.defaultValues[0] = 0.0001f;
-		np.minSliders[0] = 0.000001f;
-		np.maxSliders[0] = 1.0;
+		myPlanarHull.build(mySubsetPoints.data(), static_cast<int32_t>(mySubsetPoints.size()), mySubsetSources);
 
-		OP_ParAppendResult res = manager->appendFloat(np);
-		assert(res == OP_ParAppendResult::Success);
+		for (int32_t& index : mySubsetSources)
+		{
+			index = myCandidateSources[index];
+		}
 	}
+	else
+		myPlanarHull.build(points, numPoints, mySubsetSources);
 
-	// CCW
+	myPoints.clear();
+	myIndices.clear();
+	mySourceIndices.clear();
+
+	for (int32_t index : mySubsetSources)
 	{
-		OP_NumericParameter	np;
+		myPoints.push_back(myPlanarHull.project(points[index]));
+		mySourceIndices.push_back(index);
+	}
 
-		np.name = "Ccw";
-		np.label = "Ccw";
+	int32_t numHullPoints = static_cast<int32_t>(myPoints.size());
 
-		OP_ParAppendResult res = manager->appendToggle(np);
-		assert(res == OP_ParAppendResult::Success);
+	if (numHullPoints >= 3)
+	{
+		if (planarOutput == PlanarOutput::Polygon)
+		{
+			for (int32_t i = 0; i < numHullPoints; i++)
+			{
+				myLineIndices.push_back(i);
+			}
+			myLineIndices.push_back(0);
+		}
+		else
+		{
+			// the hull is counter-clockwise around the plane normal
+			for (int32_t i = 1; i + 1 < numHullPoints; i++)
+			{
+				myIndices.push_back(0);
+				myIndices.push_back(ccw ? i : i + 1);
+				myIndices.push_back(ccw ? i + 1 : i);
+			}
+		}
 	}
 
+	myCulledPoints = numPoints - numHullPoints;
+	myPlanar = true;
+	myOutlineNormal = myPlanarHull.getNormal();
+
+	return true;
 }
 
-void
-ConvexHull::pulsePressed(const char* name, void* reserved)
+bool
+ConvexHull::boundedHull(const Position* points, int32_t numPoints, const int32_t* extremes,
+						bool ccw, float epsilon, int32_t maxVertices,
+						const CookTrace::Clock::time_point* deadline)
 {
+	// the seed is the extreme points along the fixed directions, kept in
+	// direction order so that a small budget keeps the main axes first
+	mySubsetSources.clear();
+
+	for (int32_t k = 0; k < PointKernels::NumExtremeDirections * 2; k++)
+	{
+		int32_t index = extremes[k];
+
+		if (static_cast<int32_t>(mySubsetSources.size()) < maxVertices &&
+		    std::find(mySubsetSources.begin(), mySubsetSources.end(), index) == mySubsetSources.end())
+		{
+			mySubsetSources.push_back(index);
+		}
+	}
+
+	if (mySubsetSources.size() < 4)
+		return false;
+
+	mySubsetPoints.resize(mySubsetSources.size());
+
+	for (size_t i = 0; i < mySubsetSources.size(); i++)
+	{
+		mySubsetPoints[i] = points[mySubsetSources[i]];
+	}
+
+	// points closer to the hull than quickhull's own tolerance would not
+	// make it grow. Directions 0 to 2 are the axes.
+	float extent = std::max(std::max(points[extremes[0]].x - points[extremes[1]].x,
+	                                 points[extremes[2]].y - points[extremes[3]].y),
+	                        points[extremes[4]].z - points[extremes[5]].z);
+
+	float tolerance = epsilon * extent;
+
+	// points that can still be outside the hull, all of them at first
+	const Position* candidates = points;
+	const int32_t* candidateSources = nullptr;
+	int32_t numCandidates = numPoints;
+	int32_t lastVertices = 0;
+	int32_t round = 0;
+
+	CookClock::time_point roundStart = CookClock::now();
+	CookClock::duration lastRound = CookClock::duration::zero();
+
+	// quickhull's expansion stopped early: every round adds the point furthest
+	// in front of each face, furthest first, until the budget is spent
+	while (true)
+	{
+		TraceSpan span(myTrace, "bounded round");
+		span.addArg("round", round++);
+		span.addArg("candidates", numCandidates);
+
+		quickhull::ConvexHull<float> hull = qh.getConvexHull(
+		                                        reinterpret_cast<const float*>(mySubsetPoints.data()),
+		                                        mySubsetPoints.size(),
+		                                        ccw,
+		                                        true,
+		                                        epsilon);
+
+		myHullCounters.addRun(qh, hull, mySubsetPoints.size());
+
+		const auto& hullIndices = hull.getIndexBuffer();
+
+		Position center = PointKernels::centroid(mySubsetPoints.data(),
+		                                         static_cast<int32_t>(mySubsetPoints.size()));
+
+		// the planes are relative to the center, in the precision of the cook
+		bool doublePlanes = myPrecision == Precision::Double;
+
+		float innerRadius = doublePlanes ?
+		                    PointKernels::buildPlanes(mySubsetPoints.data(), hullIndices.data(),
+		                                              hullIndices.size() / 3, center, myDoublePlanes) :
+		                    PointKernels::buildPlanes(mySubsetPoints.data(), hullIndices.data(),
+		                                              hullIndices.size() / 3, center, myPlanes);
+
+		// a flat seed has no faces to grow from
+		if (innerRadius <= 0.0f)
+			return false;
+
+		int32_t numPlanes = static_cast<int32_t>((doublePlanes ? myDoublePlanes.size() : myPlanes.size()) / 4);
+		myFurthest.assign(numPlanes, -1);
+		myFurthestDistances.assign(numPlanes, 0.0f);
+		myBlockFurthest.resize(numPlanes);
+		myBlockDistances.resize(numPlanes);
+
+		// the input point furthest from the hull bounds the error of the
+		// approximation. The candidates are tested a block at a time, a
+		// deadline passing during the scan ends it with the hull of this round.
+		myOutside.clear();
+		float error = 0.0f;
+		bool cut = false;
+
+		for (int32_t begin = 0; begin < numCandidates; begin += BoundedScanBlock)
+		{
+			int32_t count = std::min(BoundedScanBlock, numCandidates - begin);
+			size_t firstOutside = myOutside.size();
+
+			float blockError = doublePlanes ?
+			                   PointKernels::furthestOutside(candidates + begin, count,
+			                                                 myDoublePlanes.data(), numPlanes, center, tolerance,
+			                                                 myBlockFurthest.data(), myBlockDistances.data(),
+			                                                 myOutside) :
+			                   PointKernels::furthestOutside(candidates + begin, count,
+			                                                 myPlanes.data(), numPlanes, center, tolerance,
+			                                                 myBlockFurthest.data(), myBlockDistances.data(),
+			                                                 myOutside);
+
+			error = std::max(error, blockError);
+
+			for (size_t i = firstOutside; i < myOutside.size(); i++)
+			{
+				myOutside[i] += begin;
+			}
+
+			for (int32_t j = 0; j < numPlanes; j++)
+			{
+				if (myBlockFurthest[j] >= 0 && myBlockDistances[j] > myFurthestDistances[j])
+				{
+					myFurthestDistances[j] = myBlockDistances[j];
+					myFurthest[j] = begin + myBlockFurthest[j];
+				}
+			}
+
+			if (deadline && begin + count < numCandidates && CookClock::now() >= *deadline)
+			{
+				cut = true;
+				break;
+			}
+		}
+
+		// points of the subset that ended up inside the hull don't count
+		myHullVertices.assign(hullIndices.begin(), hullIndices.end());
+		std::sort(myHullVertices.begin(), myHullVertices.end());
+
+		int32_t numVertices = static_cast<int32_t>(std::unique(myHullVertices.begin(), myHullVertices.end()) -
+		                                           myHullVertices.begin());
+		int32_t budget = maxVertices - numVertices;
+
+		// the rounds get longer as the subset grows. Stop when the next one,
+		// grown as much as the last one did, would end past the deadline.
+		CookClock::time_point now = CookClock::now();
+		CookClock::duration thisRound = now - roundStart;
+		CookClock::duration nextRound = thisRound;
+
+		if (lastRound > thisRound.zero() && thisRound > lastRound)
+			nextRound = thisRound * thisRound.count() / lastRound.count();
+
+		bool expired = cut || (deadline && now + nextRound >= *deadline);
+
+		roundStart = now;
+		lastRound = thisRound;
+
+		// stop as well if the last points added did not grow the hull
+		if (myOutside.empty() || budget <= 0 || numVertices <= lastVertices || expired)
+		{
+			storeHull(hull, mySubsetPoints.data(), mySubsetSources.data());
+
+			// a cut scan only knows the error of the points it got to
+			myApproxError = error;
+			myBudgetExpired = cut || (expired && !myOutside.empty());
+
+			if (myBudgetExpired)
+				span.addArg("expired", "true");
+
+			myCulledPoints = numPoints - static_cast<int32_t>(mySubsetPoints.size());
+
+			return true;
+		}
+
+		lastVertices = numVertices;
+		myFurthestPlanes.clear();
+
+		for (int32_t j = 0; j < numPlanes; j++)
+		{
+			if (myFurthest[j] >= 0)
+				myFurthestPlanes.push_back(j);
+		}
+
+		std::sort(myFurthestPlanes.begin(), myFurthestPlanes.end(), [this](int32_t a, int32_t b)
+		{
+			if (myFurthestDistances[a] != myFurthestDistances[b])
+				return myFurthestDistances[a] > myFurthestDistances[b];
+			return a < b;
+		});
+
+		// a point is the candidate of a single plane, they can't be added twice
+		int32_t numAdded = std::min(budget, static_cast<int32_t>(myFurthestPlanes.size()));
+
+		for (int32_t i = 0; i < numAdded; i++)
+		{
+			int32_t candidate = myFurthest[myFurthestPlanes[i]];
+
+			mySubsetPoints.push_back(candidates[candidate]);
+			mySubsetSources.push_back(candidateSources ? candidateSources[candidate] : candidate);
+		}
+
+		// the hull only grows, the points inside it now stay inside. The
+		// outside indices are ascending so the candidates compact in place
+		int32_t numOutside = static_cast<int32_t>(myOutside.size());
+
+		if (!candidateSources)
+		{
+			myCandidatePoints.resize(numOutside);
+			myCandidateSources.resize(numOutside);
+		}
+
+		for (int32_t i = 0; i < numOutside; i++)
+		{
+			int32_t candidate = myOutside[i];
+
+			myCandidatePoints[i] = candidates[candidate];
+			myCandidateSources[i] = candidateSources ? candidateSources[candidate] : candidate;
+		}
 
+		candidates = myCandidatePoints.data();
+		candidateSources = myCandidateSources.data();
+		numCandidates = numOutside;
+	}
+}
+
+bool
+ConvexHull::warmStartHull(const Position* points, int32_t numPoints, bool ccw,
+						float epsilon, double maxChange)
+{
+	// the last hull vertices only mean something if the input still has the
+	// same points, the point count is the best we can check
+	if (mySourceIndices.empty() || numPoints != myWarmNumPoints)
+		return false;
+
+	TraceSpan warmSpan(myTrace, "warm start");
+	warmSpan.addArg("seed", static_cast<int64_t>(mySourceIndices.size()));
+
+	// the seed is last cook's hull vertices at their current positions
+	mySubsetPoints.resize(mySourceIndices.size());
+	mySubsetSources.assign(mySourceIndices.begin(), mySourceIndices.end());
+
+	for (size_t i = 0; i < mySubsetSources.size(); i++)
+	{
+		mySubsetPoints[i] = points[mySubsetSources[i]];
+	}
+
+	quickhull::ConvexHull<float> seedHull = qh.getConvexHull(
+	                                            reinterpret_cast<const float*>(mySubsetPoints.data()),
+	                                            mySubsetPoints.size(),
+	                                            ccw,
+	                                            true,
+	                                            epsilon);
+
+	myHullCounters.addRun(qh, seedHull, mySubsetPoints.size());
+
+	const auto& seedIndices = seedHull.getIndexBuffer();
+
+	// every point inside the seed is inside the new hull too, only the
+	// points that left it have to go through quickhull again. A flat seed
+	// has no inside to test against.
+	if (!cullInside(points, numPoints, seedIndices.data(), seedIndices.size() / 3, epsilon))
+	{
+		myWarmFallbacks++;
+		return false;
+	}
+
+	if (myOutside.size() > maxChange * numPoints)
+	{
+		myWarmFallbacks++;
+		return false;
+	}
+
+	for (int32_t index : myOutside)
+	{
+		mySubsetPoints.push_back(points[index]);
+		mySubsetSources.push_back(index);
+	}
+
+	hullPoints(mySubsetPoints.data(), static_cast<int32_t>(mySubsetPoints.size()),
+	           mySubsetSources.data(), ccw, epsilon);
+
+	myCulledPoints = numPoints - static_cast<int32_t>(mySubsetPoints.size());
+	myWarmStarts++;
+
+	return true;
+}
+
+bool
+ConvexHull::prefilterHull(const Position* points, int32_t numPoints, const int32_t* extremes,
+						bool ccw, float epsilon)
+{
+	// Akl-Toussaint: the points that are extreme along a few fixed directions
+	// are on the hull, and anything strictly inside their own hull can't be
+	TraceSpan prefilterSpan(myTrace, "prefilter");
+
+	mySubsetSources.assign(extremes, extremes + PointKernels::NumExtremeDirections * 2);
+	std::sort(mySubsetSources.begin(), mySubsetSources.end());
+	mySubsetSources.erase(std::unique(mySubsetSources.begin(), mySubsetSources.end()), mySubsetSources.end());
+
+	mySubsetPoints.resize(mySubsetSources.size());
+
+	if (mySubsetSources.size() < 4)
+		return false;
+
+	for (size_t i = 0; i < mySubsetSources.size(); i++)
+	{
+		mySubsetPoints[i] = points[mySubsetSources[i]];
+	}
+
+	quickhull::ConvexHull<float> polytope = qh.getConvexHull(
+	                                            reinterpret_cast<const float*>(mySubsetPoints.data()),
+	                                            mySubsetPoints.size(),
+	                                            ccw,
+	                                            true,
+	                                            epsilon);
+
+	myHullCounters.addRun(qh, polytope, mySubsetPoints.size());
+
+	const auto& polytopeIndices = polytope.getIndexBuffer();
+
+	// a flat input has no inside to cull
+	if (!cullInside(points, numPoints, polytopeIndices.data(), polytopeIndices.size() / 3, epsilon))
+		return false;
+
+	for (int32_t index : myOutside)
+	{
+		mySubsetPoints.push_back(points[index]);
+		mySubsetSources.push_back(index);
+	}
+
+	hullPoints(mySubsetPoints.data(), static_cast<int32_t>(mySubsetPoints.size()),
+	           mySubsetSources.data(), ccw, epsilon);
+
+	myCulledPoints = std::max(numPoints - static_cast<int32_t>(mySubsetPoints.size()), 0);
+
+	return true;
+}
+
+bool
+ConvexHull::cullInside(const Position* points, int32_t numPoints,
+						const size_t* indices, size_t numTriangles, float epsilon)
+{
+	int32_t numSubset = static_cast<int32_t>(mySubsetPoints.size());
+
+	Position center = PointKernels::centroid(mySubsetPoints.data(), numSubset);
+
+	// points this close to the subset hull may be outside it once rounded,
+	// they are kept. The margin is never below what float coordinates
+	// relative to the center can resolve.
+	Position lower = mySubsetPoints[0];
+	Position upper = mySubsetPoints[0];
+
+	for (const Position& p : mySubsetPoints)
+	{
+		lower = Position(std::min(lower.x, p.x), std::min(lower.y, p.y), std::min(lower.z, p.z));
+		upper = Position(std::max(upper.x, p.x), std::max(upper.y, p.y), std::max(upper.z, p.z));
+	}
+
+	float extent = std::max(std::max(upper.x - lower.x, upper.y - lower.y), upper.z - lower.z);
+	float margin = std::max(epsilon, 8.0f * FLT_EPSILON) * extent;
+
+	bool doublePlanes = myPrecision == Precision::Double;
+
+	float innerRadius = doublePlanes ?
+	                    PointKernels::buildPlanes(mySubsetPoints.data(), indices, numTriangles, center, myDoublePlanes) :
+	                    PointKernels::buildPlanes(mySubsetPoints.data(), indices, numTriangles, center, myPlanes);
+
+	if (innerRadius <= 0.0f)
+		return false;
+
+	TraceSpan span(myTrace, "cull");
+	span.addArg("points", numPoints);
+
+	myOutside.clear();
+
+	if (doublePlanes)
+		PointKernels::findPointsOutside(points, numPoints,
+		                                myDoublePlanes.data(), static_cast<int32_t>(myDoublePlanes.size() / 4),
+		                                center, innerRadius, margin, myOutside);
+	else
+		PointKernels::findPointsOutside(points, numPoints,
+		                                myPlanes.data(), static_cast<int32_t>(myPlanes.size() / 4),
+		                                center, innerRadius, margin, myOutside);
+
+	// the subset points lie on the planes, within the margin, and are in
+	// already
+	myHullVertices.assign(mySubsetSources.begin(), mySubsetSources.end());
+	std::sort(myHullVertices.begin(), myHullVertices.end());
+
+	myOutside.erase(std::remove_if(myOutside.begin(), myOutside.end(), [this](int32_t index)
+	{
+		return std::binary_search(myHullVertices.begin(), myHullVertices.end(), static_cast<size_t>(index));
+	}), myOutside.end());
+
+	span.addArg("outside", static_cast<int64_t>(myOutside.size()));
+
+	return true;
+}
+
+void
+ConvexHull::endBudget()
+{
+	myDeadline = CookClock::time_point::max();
+
+	// the next cook gets another go at the complete hull
+	if (myBudgetExpired)
+		myCacheValid = false;
+}
+
+bool
+ConvexHull::budgetSpent()
+{
+	if (!myBudgetExpired && CookClock::now() >= myDeadline)
+		myBudgetExpired = true;
+
+	return myBudgetExpired;
+}
+
+void
+ConvexHull::hullPoints(const Position* points, int32_t numPoints,
+						const int32_t* sourceIndices, bool ccw, float epsilon)
+{
+	if (myPrecision == Precision::Double)
+		hullPointsWith(myDoubleHulls, points, numPoints, sourceIndices, ccw, epsilon);
+	else
+		hullPointsWith(myFloatHulls, points, numPoints, sourceIndices, ccw, epsilon);
+}
+
+template<typename T>
+void
+ConvexHull::hullPointsWith(HullEngine<T>& engine, const Position* points, int32_t numPoints,
+						const int32_t* sourceIndices, bool ccw, float epsilon)
+{
+	int32_t numChunks = std::min(myNumThreads, numPoints / MinPointsPerThread);
+
+	engine.reserve(std::max(numChunks, 1));
+
+	if (numChunks <= 1)
+	{
+		// generate the convex hull, keeping the original indices so that we
+		// know which input points ended up on the hull
+		TraceSpan span(myTrace, "quickhull");
+		span.addArg("points", numPoints);
+
+		quickhull::ConvexHull<T> hull = engine.build(0, points, numPoints, ccw, epsilon);
+
+		storeHull(hull, points, sourceIndices);
+		return;
+	}
+
+	// the hull of the points is the hull of the vertices of the hulls of any
+	// split of them. Every thread hulls a slice of the points with its own
+	// quickhull instance, then only their vertices go through the last run.
+	// Slices are contiguous index ranges, any split is valid and this one
+	// doesn't need to copy the points.
+	// the per chunk and per piece buffers only grow, so that their memory is
+	// kept when the thread or piece count goes down and back up
+	if (static_cast<int32_t>(myChunkVertices.size()) < numChunks)
+		myChunkVertices.resize(numChunks);
+
+	myThreadPool->parallelFor(numChunks, numChunks, [&](int32_t chunk)
+	{
+		int32_t begin = static_cast<int32_t>(static_cast<int64_t>(numPoints) * chunk / numChunks);
+		int32_t end = static_cast<int32_t>(static_cast<int64_t>(numPoints) * (chunk + 1) / numChunks);
+
+		// pool threads count into this node too
+		AllocationScope memoryScope(myMemory);
+
+		TraceSpan span(myTrace, "quickhull slice");
+		span.addArg("slice", chunk);
+		span.addArg("points", end - begin);
+
+		CountedVector<int32_t>& vertices = myChunkVertices[chunk];
+		vertices.clear();
+
+		quickhull::ConvexHull<T> hull = engine.build(chunk, points + begin, end - begin, ccw, epsilon);
+
+		const auto& indexBuffer = hull.getIndexBuffer();
+
+		// a slice quickhull can't make a hull of (all points on a line) is
+		// passed on whole, the last run will sort it out
+		if (indexBuffer.empty())
+		{
+			for (int32_t i = begin; i < end; i++)
+			{
+				vertices.push_back(i);
+			}
+			return;
+		}
+
+		for (size_t index : indexBuffer)
+		{
+			vertices.push_back(begin + static_cast<int32_t>(index));
+		}
+
+		std::sort(vertices.begin(), vertices.end());
+		vertices.erase(std::unique(vertices.begin(), vertices.end()), vertices.end());
+	});
+
+	// merge in input order, so the last run sees the points in the same
+	// order as a serial build would
+	myMergePoints.clear();
+	myMergeSources.clear();
+
+	for (int32_t chunk = 0; chunk < numChunks; chunk++)
+	{
+		for (int32_t index : myChunkVertices[chunk])
+		{
+			myMergePoints.push_back(points[index]);
+			myMergeSources.push_back(sourceIndices ? sourceIndices[index] : index);
+		}
+	}
+
+	TraceSpan span(myTrace, "quickhull merge");
+	span.addArg("points", static_cast<int64_t>(myMergePoints.size()));
+
+	quickhull::ConvexHull<T> hull = engine.build(0, myMergePoints.data(),
+	                                             static_cast<int32_t>(myMergePoints.size()),
+	                                             ccw, epsilon);
+
+	storeHull(hull, myMergePoints.data(), myMergeSources.data());
+}
+
+uint64_t
+ConvexHull::hashSplit(const OP_SOPInput* sinput, SplitBy splitBy, const char* splitAttrib)
+{
+	if (splitBy == SplitBy::Connectivity)
+	{
+		// the indices are stored back to back, the same ones can make other
+		// primitives: a triangle and a pentagon or two quads
+		int32_t numPrimitives = sinput->getNumPrimitives();
+		myPrimSizes.resize(numPrimitives);
+
+		for (int32_t i = 0; i < numPrimitives; i++)
+		{
+			myPrimSizes[i] = sinput->getPrimitive(i).numVertices;
+		}
+
+		return PointKernels::hashBytes(sinput->myPrimPointIndices,
+		                               sinput->getNumVertices() * sizeof(int32_t)) * 31 +
+		       PointKernels::hashBytes(myPrimSizes.data(), numPrimitives * sizeof(int32_t));
+	}
+
+	if (splitBy == SplitBy::Attribute)
+	{
+		const SOP_CustomAttribData* attrib = sinput->getCustomAttribute(splitAttrib);
+
+		uint64_t nameHash = PointKernels::hashBytes(splitAttrib, strlen(splitAttrib));
+
+		if (!attrib)
+			return nameHash;
+
+		size_t size = static_cast<size_t>(sinput->getNumPoints()) * attrib->numComponents;
+
+		if (attrib->attribType == AttribType::Int)
+			return nameHash ^ PointKernels::hashBytes(attrib->intData, size * sizeof(int32_t));
+		else
+			return nameHash ^ PointKernels::hashBytes(attrib->floatData, size * sizeof(float));
+	}
+
+	return 0;
+}
+
+int32_t
+ConvexHull::splitPieces(const OP_SOPInput* sinput, SplitBy splitBy, const char* splitAttrib)
+{
+	int32_t numPoints = sinput->getNumPoints();
+
+	// label every point with its piece, the labels are made consecutive below
+	myPieceLabels.resize(numPoints);
+
+	if (splitBy == SplitBy::Connectivity)
+	{
+		// points that share a primitive are in the same piece
+		for (int32_t i = 0; i < numPoints; i++)
+		{
+			myPieceLabels[i] = i;
+		}
+
+		for (int32_t i = 0; i < sinput->getNumPrimitives(); i++)
+		{
+			const SOP_PrimitiveInfo prim = sinput->getPrimitive(i);
+
+			if (prim.numVertices == 0)
+				continue;
+
+			int32_t root = findRoot(myPieceLabels, prim.pointIndices[0]);
+
+			for (int32_t j = 1; j < prim.numVertices; j++)
+			{
+				int32_t other = findRoot(myPieceLabels, prim.pointIndices[j]);
+
+				if (other != root)
+				{
+					// keep the lowest point index as the root, pieces are then
+					// numbered in the order of their first point
+					if (other < root)
+						std::swap(other, root);
+					myPieceLabels[other] = root;
+				}
+			}
+		}
+
+		for (int32_t i = 0; i < numPoints; i++)
+		{
+			myPieceLabels[i] = findRoot(myPieceLabels, i);
+		}
+
+		// every root is the lowest point of its piece, so walking the points in
+		// order relabels a root before any of the other points of its piece
+		int32_t numPieces = 0;
+
+		for (int32_t i = 0; i < numPoints; i++)
+		{
+			int32_t root = myPieceLabels[i];
+
+			if (root == i)
+				myPieceLabels[i] = numPieces++;
+			else
+				myPieceLabels[i] = myPieceLabels[root];
+		}
+	}
+	else
+	{
+		const SOP_CustomAttribData* attrib = sinput->getCustomAttribute(splitAttrib);
+
+		if (!attrib || attrib->numComponents < 1)
+		{
+			myWarning = std::string("Split attribute \"") + splitAttrib + "\" not found, the points are hulled as a single piece.";
+			std::fill(myPieceLabels.begin(), myPieceLabels.end(), 0);
+		}
+		else
+		{
+			// the first component, rounded when it's a float, is the piece id
+			for (int32_t i = 0; i < numPoints; i++)
+			{
+				int32_t offset = i * attrib->numComponents;
+
+				if (attrib->attribType == AttribType::Int)
+					myPieceLabels[i] = attrib->intData[offset];
+				else
+					myPieceLabels[i] = static_cast<int32_t>(floorf(attrib->floatData[offset] + 0.5f));
+			}
+
+			// pieces are numbered in increasing attribute value
+			myPieceValues.assign(myPieceLabels.begin(), myPieceLabels.end());
+			std::sort(myPieceValues.begin(), myPieceValues.end());
+			myPieceValues.erase(std::unique(myPieceValues.begin(), myPieceValues.end()), myPieceValues.end());
+
+			for (int32_t i = 0; i < numPoints; i++)
+			{
+				myPieceLabels[i] = static_cast<int32_t>(std::lower_bound(myPieceValues.begin(), myPieceValues.end(),
+				                                                         myPieceLabels[i]) - myPieceValues.begin());
+			}
+		}
+	}
+
+	int32_t numPieces = 0;
+
+	for (int32_t label : myPieceLabels)
+	{
+		numPieces = std::max(numPieces, label + 1);
+	}
+
+	// group the point indices by piece (counting sort)
+	myPieceStarts.assign(numPieces + 1, 0);
+
+	for (int32_t label : myPieceLabels)
+	{
+		myPieceStarts[label + 1]++;
+	}
+
+	for (int32_t i = 0; i < numPieces; i++)
+	{
+		myPieceStarts[i + 1] += myPieceStarts[i];
+	}
+
+	myPiecePoints.resize(numPoints);
+	myPieceFill.assign(myPieceStarts.begin(), myPieceStarts.end() - 1);
+
+	for (int32_t i = 0; i < numPoints; i++)
+	{
+		myPiecePoints[myPieceFill[myPieceLabels[i]]++] = i;
+	}
+
+	return numPieces;
+}
+
+void
+ConvexHull::hullPieces(const OP_SOPInput* sinput, SplitBy splitBy, const char* splitAttrib,
+						bool ccw, float epsilon)
+{
+	const Position* points = sinput->getPointPositions();
+
+	int32_t numPieces;
+
+	{
+		TraceSpan span(myTrace, "split");
+		numPieces = splitPieces(sinput, splitBy, splitAttrib);
+		span.addArg("pieces", numPieces);
+	}
+
+	if (static_cast<int32_t>(myPieceHulls.size()) < numPieces)
+		myPieceHulls.resize(numPieces);
+
+	// every piece measures its points against its own hull
+	if (myTagInput)
+		myHullDepths.resize(sinput->getNumPoints());
+
+	if (myPrecision == Precision::Double)
+		hullPiecesWith(myDoubleHulls, points, numPieces, ccw, epsilon);
+	else
+		hullPiecesWith(myFloatHulls, points, numPieces, ccw, epsilon);
+
+	// concatenate the pieces, offsetting their indices
+	myPoints.clear();
+	myIndices.clear();
+	mySourceIndices.clear();
+
+	for (int32_t piece = 0; piece < numPieces; piece++)
+	{
+		const PieceHull& result = myPieceHulls[piece];
+		int32_t base = static_cast<int32_t>(myPoints.size());
+
+		myPoints.insert(myPoints.end(), result.points.begin(), result.points.end());
+		mySourceIndices.insert(mySourceIndices.end(), result.sources.begin(), result.sources.end());
+		myPieceIds.insert(myPieceIds.end(), result.points.size(), piece);
+
+		for (int32_t index : result.indices)
+		{
+			myIndices.push_back(base + index);
+		}
+	}
+}
+
+template<typename T>
+void
+ConvexHull::hullPiecesWith(HullEngine<T>& engine, const Position* points, int32_t numPieces,
+						bool ccw, float epsilon)
+{
+	// every thread takes pieces one after the other and hulls them with its
+	// own quickhull instance and scratch buffers
+	int32_t numSlots = std::max(std::min(myNumThreads, numPieces), 1);
+
+	engine.reserve(numSlots);
+	if (static_cast<int32_t>(mySlotScratch.size()) < numSlots)
+		mySlotScratch.resize(numSlots);
+
+	std::atomic<int32_t> nextPiece(0);
+	std::atomic<bool> expired(false);
+
+	auto hullSlot = [&](int32_t slot)
+	{
+		AllocationScope memoryScope(myMemory);
+
+		SlotScratch& scratch = mySlotScratch[slot];
+
+		for (;;)
+		{
+			int32_t piece = nextPiece.fetch_add(1);
+
+			if (piece >= numPieces)
+				break;
+
+			PieceHull& result = myPieceHulls[piece];
+
+			int32_t begin = myPieceStarts[piece];
+			int32_t count = myPieceStarts[piece + 1] - begin;
+			const int32_t* sources = myPiecePoints.data() + begin;
+
+			// quickhull needs a volume to work with
+			if (count < 4)
+			{
+				result.points.clear();
+				result.indices.clear();
+				result.sources.clear();
+
+				if (myTagInput)
+				{
+					for (int32_t i = 0; i < count; i++)
+					{
+						myHullDepths[sources[i]] = 0.0f;
+					}
+				}
+				continue;
+			}
+
+			TraceSpan span(myTrace, "quickhull piece");
+			span.addArg("piece", piece);
+			span.addArg("points", count);
+
+			scratch.points.resize(count);
+
+			for (int32_t i = 0; i < count; i++)
+			{
+				scratch.points[i] = points[sources[i]];
+			}
+
+			// past the deadline a piece is only hulled from its extreme points
+			if (CookClock::now() >= myDeadline)
+			{
+				int32_t extremes[PointKernels::NumExtremeDirections * 2];
+				PointKernels::findExtremePoints(scratch.points.data(), count, extremes);
+
+				scratch.extremeSources.assign(extremes, extremes + PointKernels::NumExtremeDirections * 2);
+				std::sort(scratch.extremeSources.begin(), scratch.extremeSources.end());
+				scratch.extremeSources.erase(std::unique(scratch.extremeSources.begin(),
+				                                         scratch.extremeSources.end()),
+				                             scratch.extremeSources.end());
+
+				int32_t numExtremes = static_cast<int32_t>(scratch.extremeSources.size());
+				scratch.extremePoints.resize(numExtremes);
+
+				for (int32_t i = 0; i < numExtremes; i++)
+				{
+					scratch.extremePoints[i] = scratch.points[scratch.extremeSources[i]];
+					scratch.extremeSources[i] = sources[scratch.extremeSources[i]];
+				}
+
+				quickhull::ConvexHull<T> hull = engine.build(slot, scratch.extremePoints.data(), numExtremes,
+				                                             ccw, epsilon);
+
+				compactHull(hull, scratch.extremePoints.data(), scratch.extremeSources.data(), scratch.remap,
+				            result.points, result.indices, result.sources);
+
+				expired.store(true, std::memory_order_relaxed);
+				span.addArg("expired", "true");
+			}
+			else
+			{
+				quickhull::ConvexHull<T> hull = engine.build(slot, scratch.points.data(), count, ccw, epsilon);
+
+				compactHull(hull, scratch.points.data(), sources, scratch.remap,
+				            result.points, result.indices, result.sources);
+			}
+
+			if (myTagInput)
+			{
+				Position center = PointKernels::centroid(result.points.data(),
+				                                         static_cast<int32_t>(result.points.size()));
+
+				PointKernels::buildPlanes(result.points.data(), result.indices.data(),
+				                          result.indices.size() / 3, center, scratch.planes);
+
+				scratch.depths.resize(count);
+				PointKernels::planeDepths(scratch.points.data(), count, scratch.planes.data(),
+				                          static_cast<int32_t>(scratch.planes.size() / 4),
+				                          center, scratch.depths.data());
+
+				// pieces don't share points, the slots write to different entries
+				for (int32_t i = 0; i < count; i++)
+				{
+					myHullDepths[sources[i]] = scratch.depths[i];
+				}
+			}
+		}
+	};
+
+	if (numSlots > 1)
+		myThreadPool->parallelFor(numSlots, numSlots, hullSlot);
+	else
+		hullSlot(0);
+
+	if (expired.load(std::memory_order_relaxed))
+		myBudgetExpired = true;
+}
+
+template<typename T>
+void
+ConvexHull::storeHull(const quickhull::ConvexHull<T>& hull, const Position* points,
+						const int32_t* sourceIndices)
+{
+	TraceSpan span(myTrace, "compact");
+
+	compactHull(hull, points, sourceIndices, myRemap, myPoints, myIndices, mySourceIndices);
+}
+
+void
+ConvexHull::clearHull()
+{
+	myPoints.clear();
+	myIndices.clear();
+	myLineIndices.clear();
+	mySourceIndices.clear();
+	myPieceIds.clear();
+	myCacheValid = false;
+}
+
+bool
+ConvexHull::asyncHull(const OP_Inputs* inputs)
+{
+	CookClock::time_point fetchStart = CookClock::now();
+
+	const OP_TimeInfo* timeInfo = inputs->getTimeInfo();
+	int64_t frame = timeInfo ? timeInfo->absFrame : 0;
+
+	const OP_SOPInput* sinput = inputs->getNumInputs() > 0 ? inputs->getInputSOP(0) : nullptr;
+
+	myInputPoints = sinput ? sinput->getNumPoints() : 0;
+
+	if (myInputPoints == 0)
+	{
+		myWarning.clear();
+		clearHull();
+		myAsyncSubmitted = false;
+		myAsyncAge = 0;
+		myFetchMs = millisecondsSince(fetchStart);
+		return false;
+	}
+
+	if (!myAsyncWorker)
+	{
+		myAsyncBuilder.reset(new ConvexHull(myNodeInfo));
+		myAsyncWorker.reset(new AsyncWorker(&ConvexHull::runAsyncJob, this));
+	}
+
+	// the last finished hull replaces the one output so far, copying it is
+	// all the hull costs the cook thread
+	int32_t slot = myAsyncWorker->getPublished();
+
+	if (slot >= 0 && myAsyncResults[slot].sequence != myAsyncTaken)
+	{
+		TraceSpan span(myTrace, "take async hull");
+		span.addArg("vertices", static_cast<int64_t>(myAsyncResults[slot].points.size()));
+
+		loadResult(myAsyncResults[slot]);
+	}
+
+	// a busy worker gets the input of a later cook. The slot above is read
+	// before the worker is started, as the next job may write it.
+	if (!myAsyncWorker->isBusy())
+	{
+		readSettings(inputs, mySettings);
+
+		// an input that didn't change since the last job isn't copied again
+		if (!myAsyncSubmitted || sinput->totalCooks != myAsyncInput.totalCooks ||
+		    sinput->opId != myAsyncInput.opId || !(mySettings == myAsyncSettings))
+		{
+			TraceSpan span(myTrace, "async input");
+			span.addArg("points", myInputPoints);
+
+			myAsyncInput.copy(sinput, mySettings.splitBy == SplitBy::Connectivity,
+			                  mySettings.splitBy == SplitBy::Attribute ? mySettings.splitAttrib.c_str() : nullptr);
+			myAsyncSettings = mySettings;
+			myAsyncFrame = frame;
+			myAsyncSubmitted = true;
+
+			myAsyncWorker->start();
+		}
+	}
+
+	myAsyncAge = myAsyncTaken > 0 ? frame - myAsyncTakenFrame : 0;
+	myFetchMs = millisecondsSince(fetchStart);
+
+	if (myTrace.isOpen())
+	{
+		char args[64];
+		snprintf(args, sizeof(args), "\"points\": %d", myInputPoints);
+		myTrace.addSpan("fetch", fetchStart, args);
+	}
+
+	return !myPoints.empty();
+}
+
+void
+ConvexHull::runAsyncJob(void* context, int32_t slot)
+{
+	ConvexHull* node = static_cast<ConvexHull*>(context);
+	ConvexHull& builder = *node->myAsyncBuilder;
+
+	{
+		// the builder has no trace of its own, its build shows up in the
+		// node's trace on the worker thread
+		TraceSpan span(node->myTrace, "async build");
+		span.addArg("points", node->myAsyncInput.getNumPoints());
+
+		AllocationScope memoryScope(builder.myMemory);
+		builder.myMemory.beginCook();
+		builder.myHullCounters = HullCounters();
+
+		builder.computeHull(node->myAsyncSettings, &node->myAsyncInput);
+
+		span.addArg("engine", builder.myEngine);
+		span.addArg("vertices", static_cast<int64_t>(builder.myPoints.size()));
+	}
+
+	// the result slots are buffers of the node
+	AllocationScope memoryScope(node->myMemory);
+
+	TraceSpan span(node->myTrace, "async save");
+	span.addArg("slot", slot);
+
+	AsyncResult& result = node->myAsyncResults[slot];
+
+	builder.saveResult(result);
+
+	result.frame = node->myAsyncFrame;
+	result.sequence = ++node->myAsyncSequence;
+}
+
+void
+ConvexHull::saveResult(AsyncResult& result)
+{
+	result.points = myPoints;
+	result.indices = myIndices;
+	result.lineIndices = myLineIndices;
+	result.sourceIndices = mySourceIndices;
+	result.pieceIds = myPieceIds;
+	result.depths = myHullDepths;
+
+	result.outlineNormal = myOutlineNormal;
+	result.tagInput = myTagInput;
+	result.ccw = myCcw;
+	result.planar = myPlanar;
+	result.inputPoints = myInputPoints;
+	result.culledPoints = myCulledPoints;
+	result.approxError = myApproxError;
+	result.budgetExpired = myBudgetExpired;
+	result.engine = myEngine;
+	result.warning = myWarning;
+
+	result.counters = myHullCounters;
+	result.counters.add(myFloatHulls.takeCounters());
+	result.counters.add(myDoubleHulls.takeCounters());
+}
+
+void
+ConvexHull::loadResult(const AsyncResult& result)
+{
+	// assigning keeps the capacity of the buffers
+	myPoints = result.points;
+	myIndices = result.indices;
+	myLineIndices = result.lineIndices;
+	mySourceIndices = result.sourceIndices;
+	myPieceIds = result.pieceIds;
+	myHullDepths = result.depths;
+
+	myOutlineNormal = result.outlineNormal;
+	myTagInput = result.tagInput;
+	myCcw = result.ccw;
+	myPlanar = result.planar;
+	myWarmNumPoints = result.inputPoints;
+	myCulledPoints = result.culledPoints;
+	myApproxError = result.approxError;
+	myBudgetExpired = result.budgetExpired;
+	myEngine = result.engine;
+	myWarning = result.warning;
+
+	myHullCounters.add(result.counters);
+
+	// the hull isn't the one of the cache key anymore
+	myCacheValid = false;
+
+	myAsyncTaken = result.sequence;
+	myAsyncTakenFrame = result.frame;
+}
+
+int64_t
+ConvexHull::getMemoryBytes() const
+{
+	return myMemory.getCurrentBytes() + (myAsyncBuilder ? myAsyncBuilder->myMemory.getCurrentBytes() : 0);
+}
+
+void
+ConvexHull::execute(SOP_Output* output, const OP_Inputs* inputs, void* reserved)
+{
+	// count what the buffers allocate during the cook
+	AllocationScope memoryScope(myMemory);
+	myMemory.beginCook();
+	myHullCounters = HullCounters();
+
+	updateTrace(inputs);
+
+	CookClock::time_point cookStart = CookClock::now();
+	myCookStart = cookStart;
+
+	bool built = updateHull(inputs);
+
+	CookClock::time_point emitStart = CookClock::now();
+	myBuildMs = millisecondsSince(cookStart) - myFetchMs;
+	myEmitMs = 0.0f;
+
+	const OP_SOPInput* sinput = inputs->getNumInputs() > 0 ? inputs->getInputSOP(0) : nullptr;
+
+	myTagWarning.clear();
+
+	// the input goes through whole, even when it has no hull. An async hull
+	// of an input with another point count is output as a hull instead.
+	if (myTagInput && sinput && sinput->getNumPoints() > 0 &&
+	    static_cast<size_t>(sinput->getNumPoints()) == myHullDepths.size())
+	{
+		emitTaggedInput(sinput, inputs->getParInt("Attributes") ? true : false, output);
+
+		myEmitMs = millisecondsSince(emitStart);
+		myTrace.addSpan("emit", emitStart);
+
+		trimMemory(inputs);
+		recordCook();
+		return;
+	}
+
+	if (!built)
+	{
+		trimMemory(inputs);
+		recordCook();
+		return;
+	}
+
+	// the order of the hull, which in Async mode lags the parameter
+	bool ccw = myCcw;
+
+	// the source indices of an async hull only fit an input of the same size
+	bool attributes = inputs->getParInt("Attributes") && sinput->getNumPoints() == myWarmNumPoints;
+
+	HullNormals normals = static_cast<HullNormals>(inputs->getParInt("Normals"));
+
+	// a planar outline has no faces to split its points between
+	bool facets = normals == HullNormals::Face && !myIndices.empty() && myLineIndices.empty();
+
+	int32_t numTriangles = static_cast<int32_t>(myIndices.size() / 3);
+	int32_t numPoints = facets ? numTriangles * 3 : static_cast<int32_t>(myPoints.size());
+
+	if (facets)
+		buildFacets(ccw, attributes);
+
+	// add the points and the triangles of the hull to the SOP in one call each
+	output->addPoints(facets ? myFacetPoints.data() : myPoints.data(), numPoints);
+
+	if (numTriangles > 0)
+		output->addTriangles(facets ? myFacetIndices.data() : myIndices.data(), numTriangles);
+
+	// a planar hull output as a polygon is a closed line strip
+	if (!myLineIndices.empty())
+		output->addLine(myLineIndices.data(), static_cast<int32_t>(myLineIndices.size()));
+
+	// the input attributes follow the points, so they don't have to be
+	// transferred downstream
+	if (attributes)
+		carryAttributes(sinput, facets ? myFacetSources.data() : mySourceIndices.data(), numPoints, output);
+
+	// the normals are written over the carried ones, as the hull has its own
+	if (facets)
+	{
+		output->setNormals(myEmitNormals.data(), numPoints, 0);
+
+		SOP_CustomAttribData offsetAttrib("planeoffset", 1, AttribType::Float);
+		offsetAttrib.floatData = myFaceOffsets.data();
+
+		output->setCustomAttribute(&offsetAttrib, numPoints);
+	}
+	else if (normals != HullNormals::None)
+	{
+		myEmitNormals.resize(numPoints);
+		buildPointNormals(ccw, myEmitNormals.data());
+
+		output->setNormals(myEmitNormals.data(), numPoints, 0);
+	}
+
+	// tell which piece each point belongs to when the input was split
+	if (!myPieceIds.empty())
+	{
+		SOP_CustomAttribData pieceAttrib("pieceid", 1, AttribType::Int);
+		pieceAttrib.intData = facets ? myFacetPieceIds.data() : myPieceIds.data();
+
+		output->setCustomAttribute(&pieceAttrib, numPoints);
+	}
+
+	// the viewer homes on the hull without measuring it
+	output->setBoundingBox(boundsOf(myPoints.data(), static_cast<int32_t>(myPoints.size())));
+
+	myEmitMs = millisecondsSince(emitStart);
+	myTrace.addSpan("emit", emitStart);
+
+	trimMemory(inputs);
+	recordCook();
+}
+
+
+
+void
+ConvexHull::executeVBO(SOP_VBOOutput* output,
+						const OP_Inputs* inputs,
+						void* reserved)
+{
+	// a hull that is rebuilt on consecutive frames comes from an animated input,
+	// so flag it as dynamic and let the driver keep it somewhere cheap to update
+	const OP_TimeInfo* timeInfo = inputs->getTimeInfo();
+
+	bool animated = timeInfo && timeInfo->absFrame == myLastVBOFrame + 1;
+
+	if (timeInfo)
+		myLastVBOFrame = timeInfo->absFrame;
+
+	AllocationScope memoryScope(myMemory);
+	myMemory.beginCook();
+	myHullCounters = HullCounters();
+
+	updateTrace(inputs);
+
+	CookClock::time_point cookStart = CookClock::now();
+	myCookStart = cookStart;
+
+	bool built = updateHull(inputs);
+
+	CookClock::time_point emitStart = CookClock::now();
+	myBuildMs = millisecondsSince(cookStart) - myFetchMs;
+
+	if (!built)
+	{
+		output->allocVBO(0, 0, VBOBufferMode::Static);
+		output->updateComplete();
+
+		myEmitMs = millisecondsSince(emitStart);
+
+		trimMemory(inputs);
+		recordCook();
+		return;
+	}
+
+	// the order of the hull, which in Async mode lags the parameter
+	bool ccw = myCcw;
+
+	int32_t numTriangles = static_cast<int32_t>(myIndices.size() / 3);
+	int32_t numLineIndices = static_cast<int32_t>(myLineIndices.size());
+
+	const OP_SOPInput* sinput = inputs->getInputSOP(0);
+
+	// the source indices of an async hull only fit an input of the same size
+	bool attributes = inputs->getParInt("Attributes") && sinput->getNumPoints() == myWarmNumPoints;
+
+	// the VBOs always have normals, None gives the point normals
+	bool facets = static_cast<HullNormals>(inputs->getParInt("Normals")) == HullNormals::Face &&
+	              numTriangles > 0 && numLineIndices == 0;
+
+	int32_t numPoints = facets ? numTriangles * 3 : static_cast<int32_t>(myPoints.size());
+
+	if (facets)
+		buildFacets(ccw, attributes);
+
+	output->enableNormal();
+
+	if (attributes)
+		enableCarriedAttributes(sinput, output);
+
+	if (facets)
+		output->addCustomAttribute(SOP_CustomAttribInfo("planeoffset", 1, AttribType::Float));
+
+	output->allocVBO(numPoints, numTriangles * 3 + numLineIndices,
+	                 animated ? VBOBufferMode::Dynamic : VBOBufferMode::Static);
+
+	if (attributes)
+		carryAttributes(sinput, facets ? myFacetSources.data() : mySourceIndices.data(), numPoints, output);
+
+	Position* outPos = output->getPos();
+	Vector* outNormals = output->getNormals();
+
+	memcpy(outPos, facets ? myFacetPoints.data() : myPoints.data(), numPoints * sizeof(Position));
+
+	if (numTriangles > 0)
+	{
+		int32_t* outIndices = output->addTriangles(numTriangles);
+		memcpy(outIndices, facets ? myFacetIndices.data() : myIndices.data(), numTriangles * 3 * sizeof(int32_t));
+	}
+
+	if (numLineIndices > 0)
+	{
+		int32_t* outIndices = output->addLines(numLineIndices);
+		memcpy(outIndices, myLineIndices.data(), numLineIndices * sizeof(int32_t));
+	}
+
+	if (facets)
+	{
+		memcpy(outNormals, myEmitNormals.data(), numPoints * sizeof(Vector));
+
+		SOP_CustomAttribData offsets;
+
+		// the data of a VBO attribute is handed out const but is meant to be filled
+		if (output->getCustomAttribute(&offsets, "planeoffset") && offsets.floatData)
+			memcpy(const_cast<float*>(offsets.floatData), myFaceOffsets.data(), numPoints * sizeof(float));
+	}
+	else
+	{
+		buildPointNormals(ccw, outNormals);
+	}
+
+	output->setBoundingBox(boundsOf(myPoints.data(), static_cast<int32_t>(myPoints.size())));
+
+	output->updateComplete();
+
+	myEmitMs = millisecondsSince(emitStart);
+	myTrace.addSpan("emit", emitStart);
+
+	trimMemory(inputs);
+	recordCook();
+}
+
+void
+ConvexHull::computeDepths(const Position* points, int32_t numPoints)
+{
+	TraceSpan span(myTrace, "hull distance");
+	span.addArg("points", numPoints);
+
+	int32_t numHullPoints = static_cast<int32_t>(myPoints.size());
+
+	Position center = PointKernels::centroid(myPoints.data(), numHullPoints);
+
+	// a 2D hull is measured in its plane, from its outline
+	if (myPlanar)
+		myPlanarHull.buildEdgePlanes(myPoints.data(), numHullPoints, center, myPlanes);
+	else
+		PointKernels::buildPlanes(myPoints.data(), myIndices.data(), myIndices.size() / 3, center, myPlanes);
+
+	int32_t numPlanes = static_cast<int32_t>(myPlanes.size() / 4);
+
+	myHullDepths.resize(numPoints);
+
+	// every point is tested against every face, split large inputs over the threads
+	int32_t numChunks = std::min(myNumThreads, numPoints / MinPointsPerThread);
+
+	if (numChunks <= 1)
+	{
+		PointKernels::planeDepths(points, numPoints, myPlanes.data(), numPlanes, center, myHullDepths.data());
+		return;
+	}
+
+	myThreadPool->parallelFor(numChunks, numChunks, [&](int32_t chunk)
+	{
+		int32_t begin = static_cast<int32_t>(static_cast<int64_t>(numPoints) * chunk / numChunks);
+		int32_t end = static_cast<int32_t>(static_cast<int64_t>(numPoints) * (chunk + 1) / numChunks);
+
+		PointKernels::planeDepths(points + begin, end - begin, myPlanes.data(), numPlanes, center,
+		                          myHullDepths.data() + begin);
+	});
+}
+
+void
+ConvexHull::emitTaggedInput(const OP_SOPInput* sinput, bool attributes, SOP_Output* output)
+{
+	TraceSpan span(myTrace, "tag input");
+
+	int32_t numPoints = sinput->getNumPoints();
+	int32_t numPrims = sinput->getNumPrimitives();
+
+	output->addPoints(sinput->getPointPositions(), numPoints);
+
+	// triangles go in one call straight from the input's index list, other
+	// polygons become fans of triangles as that's all SOP_Output takes
+	int32_t numFanned = 0;
+
+	for (int32_t i = 0; i < numPrims; i++)
+	{
+		if (sinput->getPrimitive(i).numVertices != 3)
+			numFanned++;
+	}
+
+	if (numFanned == 0)
+	{
+		if (numPrims > 0)
+			output->addTriangles(sinput->myPrimPointIndices, numPrims);
+	}
+	else
+	{
+		for (int32_t i = 0; i < numPrims; i++)
+		{
+			const SOP_PrimitiveInfo prim = sinput->getPrimitive(i);
+
+			for (int32_t j = 1; j + 1 < prim.numVertices; j++)
+			{
+				output->addTriangle(prim.pointIndices[0], prim.pointIndices[j], prim.pointIndices[j + 1]);
+			}
+		}
+
+		myTagWarning = "Input polygons with more than 3 vertices are output as triangle fans: " +
+		               std::to_string(numFanned) + " of them.";
+	}
+
+	// the attributes of the input are passed on as they are
+	if (attributes)
+	{
+		if (const SOP_NormalInfo* normals = getPointNormals(sinput))
+			output->setNormals(normals->normals, numPoints, 0);
+
+		if (const SOP_ColorInfo* colors = getPointColors(sinput))
+			output->setColors(colors->colors, numPoints, 0);
+
+		if (const SOP_TextureInfo* textures = getPointTextures(sinput))
+			output->setTexCoords(textures->textures, numPoints, textures->numTextureLayers, 0);
+
+		for (int32_t i = 0; i < sinput->getNumCustomAttributes(); i++)
+		{
+			const SOP_CustomAttribData* attrib = sinput->getCustomAttribute(i);
+
+			// written over below
+			if (attrib && strcmp(attrib->name, "hulldist"))
+				output->setCustomAttribute(attrib, numPoints);
+		}
+	}
+
+	output->addGroup(SOP_GroupType::Point, "hull");
+
+	for (int32_t index : mySourceIndices)
+	{
+		output->addPointToGroup(index, "hull");
+	}
+
+	SOP_CustomAttribData depthAttrib("hulldist", 1, AttribType::Float);
+	depthAttrib.floatData = myHullDepths.data();
+
+	output->setCustomAttribute(&depthAttrib, numPoints);
+}
+
+void
+ConvexHull::carryAttributes(const OP_SOPInput* sinput, const int32_t* sources,
+							int32_t numPoints, SOP_Output* output)
+{
+	TraceSpan span(myTrace, "attributes");
+
+	if (const SOP_NormalInfo* normals = getPointNormals(sinput))
+	{
+		myCarryNormals.resize(numPoints);
+		gatherPoints(normals->normals, 1, sources, numPoints, myCarryNormals.data());
+
+		output->setNormals(myCarryNormals.data(), numPoints, 0);
+	}
+
+	if (const SOP_ColorInfo* colors = getPointColors(sinput))
+	{
+		myCarryColors.resize(numPoints);
+		gatherPoints(colors->colors, 1, sources, numPoints, myCarryColors.data());
+
+		output->setColors(myCarryColors.data(), numPoints, 0);
+	}
+
+	if (const SOP_TextureInfo* textures = getPointTextures(sinput))
+	{
+		int32_t numLayers = textures->numTextureLayers;
+
+		myCarryTexCoords.resize(static_cast<size_t>(numPoints) * numLayers);
+		gatherPoints(textures->textures, numLayers, sources, numPoints, myCarryTexCoords.data());
+
+		output->setTexCoords(myCarryTexCoords.data(), numPoints, numLayers, 0);
+	}
+
+	for (int32_t i = 0; i < sinput->getNumCustomAttributes(); i++)
+	{
+		const SOP_CustomAttribData* attrib = sinput->getCustomAttribute(i);
+
+		// the piece ids of a split input are written over it afterwards
+		if (!attrib || (!myPieceIds.empty() && !strcmp(attrib->name, "pieceid")))
+			continue;
+
+		SOP_CustomAttribData carried(attrib->name, attrib->numComponents, attrib->attribType);
+		size_t size = static_cast<size_t>(numPoints) * attrib->numComponents;
+
+		if (attrib->attribType == AttribType::Float)
+		{
+			myCarryFloats.resize(size);
+			PointKernels::gather(attrib->floatData, attrib->numComponents, sources, numPoints,
+			                     myCarryFloats.data());
+			carried.floatData = myCarryFloats.data();
+		}
+		else
+		{
+			myCarryInts.resize(size);
+			PointKernels::gather(attrib->intData, attrib->numComponents, sources, numPoints,
+			                     myCarryInts.data());
+			carried.intData = myCarryInts.data();
+		}
+
+		output->setCustomAttribute(&carried, numPoints);
+	}
+}
+
+void
+ConvexHull::enableCarriedAttributes(const OP_SOPInput* sinput, SOP_VBOOutput* output)
+{
+	if (getPointColors(sinput))
+		output->enableColor();
+
+	if (const SOP_TextureInfo* textures = getPointTextures(sinput))
+		output->enableTexCoord(textures->numTextureLayers);
+
+	for (int32_t i = 0; i < sinput->getNumCustomAttributes(); i++)
+	{
+		const SOP_CustomAttribData* attrib = sinput->getCustomAttribute(i);
+
+		if (attrib)
+			output->addCustomAttribute(SOP_CustomAttribInfo(attrib->name, attrib->numComponents, attrib->attribType));
+	}
+}
+
+void
+ConvexHull::carryAttributes(const OP_SOPInput* sinput, const int32_t* sources,
+							int32_t numPoints, SOP_VBOOutput* output)
+{
+	TraceSpan span(myTrace, "attributes");
+
+	// the VBOs are filled in place, nothing goes through the node's buffers
+	const SOP_ColorInfo* colors = getPointColors(sinput);
+
+	if (colors && output->getColors())
+		gatherPoints(colors->colors, 1, sources, numPoints, output->getColors());
+
+	const SOP_TextureInfo* textures = getPointTextures(sinput);
+
+	if (textures && output->getTexCoords() && output->getNumTexCoordLayers() == textures->numTextureLayers)
+		gatherPoints(textures->textures, textures->numTextureLayers, sources, numPoints, output->getTexCoords());
+
+	for (int32_t i = 0; i < sinput->getNumCustomAttributes(); i++)
+	{
+		const SOP_CustomAttribData* attrib = sinput->getCustomAttribute(i);
+		SOP_CustomAttribData buffer;
+
+		if (!attrib || !output->getCustomAttribute(&buffer, attrib->name))
+			continue;
+
+		// the data of a VBO attribute is handed out const but is meant to be filled
+		if (attrib->attribType == AttribType::Float && buffer.floatData)
+			PointKernels::gather(attrib->floatData, attrib->numComponents, sources, numPoints,
+			                     const_cast<float*>(buffer.floatData));
+		else if (attrib->attribType == AttribType::Int && buffer.intData)
+			PointKernels::gather(attrib->intData, attrib->numComponents, sources, numPoints,
+			                     const_cast<int32_t*>(buffer.intData));
+	}
+}
+
+void
+ConvexHull::buildPointNormals(bool ccw, Vector* normals) const
+{
+	int32_t numPoints = static_cast<int32_t>(myPoints.size());
+	int32_t numTriangles = static_cast<int32_t>(myIndices.size() / 3);
+
+	// the hull shares its vertices between faces, so the point normals are the
+	// area weighted sum of the face normals around each vertex. With clockwise
+	// winding the cross product points inwards and has to be flipped.
+	float facing = ccw ? 1.0f : -1.0f;
+
+	// a planar outline has no faces, its points all face along the plane normal
+	Vector startNormal = !myLineIndices.empty() ? myOutlineNormal : Vector(0.0f, 0.0f, 0.0f);
+
+	for (int32_t i = 0; i < numPoints; i++)
+	{
+		normals[i] = startNormal;
+	}
+
+	for (int32_t i = 0; i < numTriangles; i++)
+	{
+		int32_t a = myIndices[i * 3];
+		int32_t b = myIndices[i * 3 + 1];
+		int32_t c = myIndices[i * 3 + 2];
+
+		const Position& pa = myPoints[a];
+		const Position& pb = myPoints[b];
+		const Position& pc = myPoints[c];
+
+		Vector ab(pb.x - pa.x, pb.y - pa.y, pb.z - pa.z);
+		Vector ac(pc.x - pa.x, pc.y - pa.y, pc.z - pa.z);
+
+		Vector n((ab.y * ac.z - ab.z * ac.y) * facing,
+		         (ab.z * ac.x - ab.x * ac.z) * facing,
+		         (ab.x * ac.y - ab.y * ac.x) * facing);
+
+		normals[a] += n;
+		normals[b] += n;
+		normals[c] += n;
+	}
+
+	for (int32_t i = 0; i < numPoints; i++)
+	{
+		normals[i].normalize();
+	}
+}
+
+void
+ConvexHull::buildFacets(bool ccw, bool sources)
+{
+	TraceSpan span(myTrace, "facets");
+
+	int32_t numTriangles = static_cast<int32_t>(myIndices.size() / 3);
+	int32_t numPoints = numTriangles * 3;
+
+	span.addArg("triangles", numTriangles);
+
+	myFacetPoints.resize(numPoints);
+	myEmitNormals.resize(numPoints);
+	myFaceOffsets.resize(numPoints);
+
+	// the triangles of separate points are always 0, 1, 2, ...
+	int32_t numIndices = static_cast<int32_t>(myFacetIndices.size());
+
+	if (numIndices < numPoints)
+	{
+		myFacetIndices.resize(numPoints);
+
+		for (int32_t i = numIndices; i < numPoints; i++)
+		{
+			myFacetIndices[i] = i;
+		}
+	}
+
+	float facing = ccw ? 1.0f : -1.0f;
+
+	for (int32_t i = 0; i < numPoints; i += 3)
+	{
+		const Position& pa = myPoints[myIndices[i]];
+		const Position& pb = myPoints[myIndices[i + 1]];
+		const Position& pc = myPoints[myIndices[i + 2]];
+
+		Vector ab(pb.x - pa.x, pb.y - pa.y, pb.z - pa.z);
+		Vector ac(pc.x - pa.x, pc.y - pa.y, pc.z - pa.z);
+
+		Vector n((ab.y * ac.z - ab.z * ac.y) * facing,
+		         (ab.z * ac.x - ab.x * ac.z) * facing,
+		         (ab.x * ac.y - ab.y * ac.x) * facing);
+
+		n.normalize();
+
+		// the plane of the face is n.p = offset
+		float offset = n.x * pa.x + n.y * pa.y + n.z * pa.z;
+
+		myFacetPoints[i] = pa;
+		myFacetPoints[i + 1] = pb;
+		myFacetPoints[i + 2] = pc;
+
+		for (int32_t j = i; j < i + 3; j++)
+		{
+			myEmitNormals[j] = n;
+			myFaceOffsets[j] = offset;
+		}
+	}
+
+	if (sources)
+	{
+		myFacetSources.resize(numPoints);
+		PointKernels::gather(mySourceIndices.data(), 1, myIndices.data(), numPoints, myFacetSources.data());
+	}
+
+	if (!myPieceIds.empty())
+	{
+		myFacetPieceIds.resize(numPoints);
+		PointKernels::gather(myPieceIds.data(), 1, myIndices.data(), numPoints, myFacetPieceIds.data());
+	}
+}
+
+void
+ConvexHull::updateTrace(const OP_Inputs* inputs)
+{
+	myTraceWarning.clear();
+
+	if (!inputs->getParInt("Trace"))
+	{
+		myTrace.close();
+		return;
+	}
+
+	const char* path = inputs->getParFilePath("Tracefile");
+
+	if (!path || !path[0] || !myTrace.open(path))
+		myTraceWarning = std::string("Could not write the trace file \"") + (path ? path : "") + "\".";
+}
+
+void
+ConvexHull::recordCook()
+{
+	CookRecord record;
+	record.inputPoints = myInputPoints;
+	record.hullVertices = static_cast<int32_t>(myPoints.size());
+	record.hullFaces = static_cast<int32_t>(myIndices.size() / 3 + (myLineIndices.empty() ? 0 : 1));
+	record.engine = myEngine;
+	record.milliseconds = myFetchMs + myBuildMs + myEmitMs;
+
+	// the runs of the engines, the culling steps counted theirs already
+	myHullCounters.add(myFloatHulls.takeCounters());
+	myHullCounters.add(myDoubleHulls.takeCounters());
+
+	myCookStats.add(record);
+
+	if (myTrace.isOpen())
+	{
+		char args[160];
+		snprintf(args, sizeof(args),
+		         "\"cook\": %lld, \"engine\": \"%s\", \"points\": %d, \"hull_vertices\": %d, \"hull_faces\": %d",
+		         static_cast<long long>(myCookStats.getRecent(0).cook), record.engine, record.inputPoints,
+		         record.hullVertices, record.hullFaces);
+
+		myTrace.addSpan("cook", myCookStart, args);
+		myTrace.flush();
+	}
+}
+
+void
+ConvexHull::trimMemory(const OP_Inputs* inputs)
+{
+	int32_t trimAfter = inputs->getParInt("Trimafter");
+	double capBytes = inputs->getParDouble("Memorycap") * 1048576.0;
+
+	myLargestInput = std::max(myLargestInput, myInputPoints);
+
+	// after enough cooks in a row on an input much smaller than the largest
+	// one, the scratch that grew for the large one is given back
+	if (static_cast<int64_t>(myInputPoints) * SmallCookRatio < myLargestInput)
+		mySmallCooks++;
+	else
+		mySmallCooks = 0;
+
+	bool release = trimAfter > 0 && mySmallCooks >= trimAfter;
+
+	// what the last release kept may have changed with the cap or a smaller
+	// input, it is measured again at the next release
+	if (capBytes != myKeptCap || myInputPoints < myKeptPoints)
+		myKeptBytes = 0;
+
+	// the cap is on the buffers of the node, the memory_bytes channel. The
+	// hull is kept, and once a release showed that it alone is over the cap,
+	// releasing the scratch after every cook would only have it allocated
+	// again by the next one.
+	bool overCap = capBytes > 0.0 && getMemoryBytes() > capBytes;
+
+	if (overCap && myKeptBytes <= capBytes)
+		release = true;
+
+	if (release)
+	{
+		TraceSpan span(myTrace, "release memory");
+		span.addArg("bytes", getMemoryBytes());
+
+		releaseMemory();
+
+		myKeptBytes = getMemoryBytes();
+		myKeptCap = capBytes;
+		myKeptPoints = myInputPoints;
+	}
+
+	myMemoryWarning.clear();
+
+	if (capBytes > 0.0 && myKeptBytes > capBytes)
+	{
+		char warning[160];
+		snprintf(warning, sizeof(warning), "Memory Cap is below the %.1f MB the hull keeps, the memory is not released for it.",
+		         myKeptBytes / 1048576.0);
+		myMemoryWarning = warning;
+	}
+}
+
+void
+ConvexHull::releaseMemory()
+{
+	freeBuffer(myRemap);
+
+	freeBuffer(myCarryNormals);
+	freeBuffer(myCarryColors);
+	freeBuffer(myCarryTexCoords);
+	freeBuffer(myCarryFloats);
+	freeBuffer(myCarryInts);
+
+	freeBuffer(myFacetPoints);
+	freeBuffer(myFacetIndices);
+	freeBuffer(myFacetSources);
+	freeBuffer(myFacetPieceIds);
+	freeBuffer(myFaceOffsets);
+	freeBuffer(myEmitNormals);
+
+	freeBuffer(mySubsetPoints);
+	freeBuffer(mySubsetSources);
+	freeBuffer(myPlanes);
+	freeBuffer(myDoublePlanes);
+	freeBuffer(myOutside);
+
+	freeBuffer(myCandidatePoints);
+	freeBuffer(myCandidateSources);
+	freeBuffer(myFurthest);
+	freeBuffer(myFurthestDistances);
+	freeBuffer(myFurthestPlanes);
+	freeBuffer(myHullVertices);
+
+	freeBuffer(myChunkVertices);
+	freeBuffer(myMergePoints);
+	freeBuffer(myMergeSources);
+
+	freeBuffer(myPrimSizes);
+	freeBuffer(myPieceLabels);
+	freeBuffer(myPieceValues);
+	freeBuffer(myPieceStarts);
+	freeBuffer(myPieceFill);
+	freeBuffer(myPiecePoints);
+	freeBuffer(myPieceHulls);
+	freeBuffer(mySlotScratch);
+
+	myPlanarHull.releaseMemory();
+
+	// the worker's buffers can only be freed while it is idle, a later
+	// release gets them otherwise
+	if (myAsyncWorker && !myAsyncWorker->isBusy())
+	{
+		myAsyncBuilder->releaseMemory();
+		myAsyncInput.release();
+		myAsyncSubmitted = false;
+	}
+
+	// quickhull keeps its buffers as big as the largest input it hulled and
+	// has no way to shrink them, new instances start empty
+	qh = quickhull::QuickHull<float>();
+	myFloatHulls.release();
+	myDoubleHulls.release();
+
+	myLargestInput = myInputPoints;
+	mySmallCooks = 0;
+	myMemoryReleases++;
+}
+
+//-----------------------------------------------------------------------------------------------------
+//								CHOP, DAT, and custom parameters
+//-----------------------------------------------------------------------------------------------------
+
+int32_t
+ConvexHull::getNumInfoCHOPChans(void* reserved)
+{
+	// We return the number of channel we want to output to any Info CHOP
+	// connected to the CHOP. In this example we are just going to send 23 channels.
+	return 23;
+}
+
+void
+ConvexHull::getInfoCHOPChan(int32_t index,
+								OP_InfoCHOPChan* chan, void* reserved)
+{
+	// the cache counters, to check that the node doesn't recompute the hull
+	// when it cooks for other reasons than its input changing
+	if (index == 0)
+	{
+		chan->name->setString("cache_hits");
+		chan->value = static_cast<float>(myCacheHits);
+	}
+
+	if (index == 1)
+	{
+		chan->name->setString("cache_misses");
+		chan->value = static_cast<float>(myCacheMisses);
+	}
+
+	// how often the warm start could reuse the last hull, and how often it
+	// had to fall back to a full rebuild
+	if (index == 2)
+	{
+		chan->name->setString("warm_starts");
+		chan->value = static_cast<float>(myWarmStarts);
+	}
+
+	if (index == 3)
+	{
+		chan->name->setString("warm_fallbacks");
+		chan->value = static_cast<float>(myWarmFallbacks);
+	}
+
+	// number of input points that were dropped before quickhull in the last build
+	if (index == 4)
+	{
+		chan->name->setString("culled_points");
+		chan->value = static_cast<float>(myCulledPoints);
+	}
+
+	// 1 when the last hull came from the 2D engine
+	if (index == 5)
+	{
+		chan->name->setString("planar");
+		chan->value = myPlanar ? 1.0f : 0.0f;
+	}
+
+	// distance of the input point furthest outside the approximate hull,
+	// 0 when the hull is exact
+	if (index == 6)
+	{
+		chan->name->setString("approx_error");
+		chan->value = myApproxError;
+	}
+
+	// where the last cook spent its time, in milliseconds: reading and
+	// hashing the input, building the hull (~0 on a cache hit) and handing
+	// the result to the SOP or the VBOs
+	if (index == 7)
+	{
+		chan->name->setString("input_fetch_ms");
+		chan->value = myFetchMs;
+	}
+
+	if (index == 8)
+	{
+		chan->name->setString("hull_build_ms");
+		chan->value = myBuildMs;
+	}
+
+	if (index == 9)
+	{
+		chan->name->setString("output_emit_ms");
+		chan->value = myEmitMs;
+	}
+
+	// size of the last cook's input and hull
+	if (index == 10)
+	{
+		chan->name->setString("input_points");
+		chan->value = static_cast<float>(myInputPoints);
+	}
+
+	if (index == 11)
+	{
+		chan->name->setString("hull_vertices");
+		chan->value = static_cast<float>(myPoints.size());
+	}
+
+	// a planar hull output as a polygon is a single face
+	if (index == 12)
+	{
+		chan->name->setString("hull_faces");
+		chan->value = static_cast<float>(myIndices.size() / 3 + (myLineIndices.empty() ? 0 : 1));
+	}
+
+	// memory held by the node's buffers now, the async builder's included,
+	// the most they held during the last cook, and how many blocks that cook
+	// allocated. quickhull's own buffers are not included.
+	if (index == 13)
+	{
+		chan->name->setString("memory_bytes");
+		chan->value = static_cast<float>(getMemoryBytes());
+	}
+
+	if (index == 14)
+	{
+		chan->name->setString("memory_peak_bytes");
+		chan->value = static_cast<float>(myMemory.getPeakBytes());
+	}
+
+	if (index == 15)
+	{
+		chan->name->setString("allocations");
+		chan->value = static_cast<float>(myMemory.getAllocations());
+	}
+
+	// what quickhull did in the last cook, over all its runs: how many runs,
+	// the points given to them and the faces they returned, and the horizon
+	// edges it failed to close, which show numerical trouble. Many points per
+	// face means culling pays off, few means most points are on the hull and
+	// the build degrades.
+	if (index == 16)
+	{
+		chan->name->setString("qh_runs");
+		chan->value = static_cast<float>(myHullCounters.runs);
+	}
+
+	if (index == 17)
+	{
+		chan->name->setString("qh_points");
+		chan->value = static_cast<float>(myHullCounters.points);
+	}
+
+	if (index == 18)
+	{
+		chan->name->setString("qh_faces");
+		chan->value = static_cast<float>(myHullCounters.faces);
+	}
+
+	if (index == 19)
+	{
+		chan->name->setString("qh_failed_horizon_edges");
+		chan->value = static_cast<float>(myHullCounters.failedHorizonEdges);
+	}
+
+	// how many times the trim policy or the Release Memory pulse freed the
+	// scratch memory
+	if (index == 20)
+	{
+		chan->name->setString("memory_releases");
+		chan->value = static_cast<float>(myMemoryReleases);
+	}
+
+	// frames between the input of the hull being output and the current
+	// one, 0 when the hull is built in the cook
+	if (index == 21)
+	{
+		chan->name->setString("async_age_frames");
+		chan->value = static_cast<float>(myAsyncAge);
+	}
+
+	// 1 when the time budget ran out and the hull is approximate, its error
+	// is in approx_error
+	if (index == 22)
+	{
+		chan->name->setString("budget_expired");
+		chan->value = myBudgetExpired ? 1.0f : 0.0f;
+	}
+}
+
+// Rows of the Info DAT above the recent cooks: the latency percentiles with
+// their header, then the header of the recent cooks
+static const int32_t InfoDATHeaderRows = 3;
+
+// Number of recent cooks listed in the Info DAT, the percentiles are over the
+// whole CookStats window
+static const int32_t InfoDATRecentCooks = 16;
+
+bool
+ConvexHull::getInfoDATSize(OP_InfoDATSize* infoSize, void* reserved)
+{
+	infoSize->rows = InfoDATHeaderRows + std::min(myCookStats.getCount(), InfoDATRecentCooks);
+	infoSize->cols = 6;
+	// Setting this to false means we'll be assigning values to the table
+	// one row at a time. True means we'll do it one column at a time.
+	infoSize->byColumn = false;
+	return true;
+}
+
+void
+ConvexHull::getInfoDATEntries(int32_t index,
+								int32_t nEntries,
+								OP_InfoDATEntries* entries,
+								void* reserved)
+{
+	char buffer[64];
+
+	for (int32_t i = 0; i < nEntries; i++)
+	{
+		entries->values[i]->setString("");
+	}
+
+	// cook latency over the window, in milliseconds
+	if (index == 0)
+	{
+		const char* header[] = { "latency_ms", "p50", "p95", "p99", "max", "cooks" };
+
+		for (int32_t i = 0; i < nEntries; i++)
+		{
+			entries->values[i]->setString(header[i]);
+		}
+	}
+
+	if (index == 1)
+	{
+		float values[] = { myCookStats.getPercentile(50.0f),
+		                   myCookStats.getPercentile(95.0f),
+		                   myCookStats.getPercentile(99.0f),
+		                   myCookStats.getPercentile(100.0f) };
+
+		entries->values[0]->setString("window");
+
+		for (int32_t i = 0; i < 4; i++)
+		{
+			snprintf(buffer, sizeof(buffer), "%.3f", values[i]);
+			entries->values[i + 1]->setString(buffer);
+		}
+
+		snprintf(buffer, sizeof(buffer), "%d", myCookStats.getCount());
+		entries->values[5]->setString(buffer);
+	}
+
+	// the most recent cooks, newest first
+	if (index == 2)
+	{
+		const char* header[] = { "cook", "points_in", "hull_vertices", "hull_faces", "engine", "ms" };
+
+		for (int32_t i = 0; i < nEntries; i++)
+		{
+			entries->values[i]->setString(header[i]);
+		}
+	}
+
+	if (index >= InfoDATHeaderRows)
+	{
+		const CookRecord& record = myCookStats.getRecent(index - InfoDATHeaderRows);
+
+		snprintf(buffer, sizeof(buffer), "%lld", static_cast<long long>(record.cook));
+		entries->values[0]->setString(buffer);
+
+		snprintf(buffer, sizeof(buffer), "%d", record.inputPoints);
+		entries->values[1]->setString(buffer);
+
+		snprintf(buffer, sizeof(buffer), "%d", record.hullVertices);
+		entries->values[2]->setString(buffer);
+
+		snprintf(buffer, sizeof(buffer), "%d", record.hullFaces);
+		entries->values[3]->setString(buffer);
+
+		entries->values[4]->setString(record.engine);
+
+		snprintf(buffer, sizeof(buffer), "%.3f", record.milliseconds);
+		entries->values[5]->setString(buffer);
+	}
+}
+
+
+
+void
+ConvexHull::setupParameters(OP_ParameterManager* manager, void* reserved)
+{
+	// Epsilon
+	{
+		OP_NumericParameter	np;
+
+		np.name = "Epsilon";
+		np.label = "Epsilon";
+		np.defaultValues[0] = 0.0001f;
+		np.minSliders[0] = 0.000001f;
+		np.maxSliders[0] = 1.0;
+
+		OP_ParAppendResult res = manager->appendFloat(np);
+		assert(res == OP_ParAppendResult::Success);
+	}
+
+	// CCW
+	{
+		OP_NumericParameter	np;
+
+		np.name = "Ccw";
+		np.label = "Ccw";
+
+		OP_ParAppendResult res = manager->appendToggle(np);
+		assert(res == OP_ParAppendResult::Success);
+	}
+
+	// Output
+	{
+		OP_StringParameter	sp;
+
+		sp.name = "Output";
+		sp.label = "Output";
+		sp.defaultValue = "Hull";
+
+		const char* names[] = { "Hull", "Taginput" };
+		const char* labels[] = { "Hull", "Tag Input Points" };
+
+		OP_ParAppendResult res = manager->appendMenu(sp, 2, names, labels);
+		assert(res == OP_ParAppendResult::Success);
+	}
+
+	// Normals
+	{
+		OP_StringParameter	sp;
+
+		sp.name = "Normals";
+		sp.label = "Normals";
+		sp.defaultValue = "None";
+
+		const char* names[] = { "None", "Point", "Face" };
+		const char* labels[] = { "None", "Point", "Face" };
+
+		OP_ParAppendResult res = manager->appendMenu(sp, 3, names, labels);
+		assert(res == OP_ParAppendResult::Success);
+	}
+
+	// Attributes
+	{
+		OP_NumericParameter	np;
+
+		np.name = "Attributes";
+		np.label = "Keep Point Attributes";
+		np.defaultValues[0] = 1.0;
+
+		OP_ParAppendResult res = manager->appendToggle(np);
+		assert(res == OP_ParAppendResult::Success);
+	}
+
+	// Cache
+	{
+		OP_NumericParameter	np;
+
+		np.name = "Cache";
+		np.label = "Cache Hull";
+		np.defaultValues[0] = 1.0;
+
+		OP_ParAppendResult res = manager->appendToggle(np);
+		assert(res == OP_ParAppendResult::Success);
+	}
+
+	// Warm start
+	{
+		OP_NumericParameter	np;
+
+		np.name = "Warmstart";
+		np.label = "Warm Start";
+
+		OP_ParAppendResult res = manager->appendToggle(np);
+		assert(res == OP_ParAppendResult::Success);
+	}
+
+	// Warm start threshold
+	{
+		OP_NumericParameter	np;
+
+		np.name = "Warmthreshold";
+		np.label = "Warm Start Max Change";
+		np.defaultValues[0] = 0.1;
+		np.minValues[0] = 0.0;
+		np.maxValues[0] = 1.0;
+		np.clampMins[0] = true;
+		np.clampMaxes[0] = true;
+
+		OP_ParAppendResult res = manager->appendFloat(np);
+		assert(res == OP_ParAppendResult::Success);
+	}
+
+	// Prefilter
+	{
+		OP_NumericParameter	np;
+
+		np.name = "Prefilter";
+		np.label = "Extreme Point Prefilter";
+
+		OP_ParAppendResult res = manager->appendToggle(np);
+		assert(res == OP_ParAppendResult::Success);
+	}
+
+	// Dimension
+	{
+		OP_StringParameter	sp;
+
+		sp.name = "Dimension";
+		sp.label = "Dimension";
+		sp.defaultValue = "Auto";
+
+		const char* names[] = { "Auto", "3D", "2D" };
+		const char* labels[] = { "Auto", "3D", "2D" };
+
+		OP_ParAppendResult res = manager->appendMenu(sp, 3, names, labels);
+		assert(res == OP_ParAppendResult::Success);
+	}
+
+	// Plane
+	{
+		OP_StringParameter	sp;
+
+		sp.name = "Plane";
+		sp.label = "Plane";
+		sp.defaultValue = "Auto";
+
+		const char* names[] = { "Auto", "XY", "YZ", "ZX" };
+		const char* labels[] = { "Auto", "XY", "YZ", "ZX" };
+
+		OP_ParAppendResult res = manager->appendMenu(sp, 4, names, labels);
+		assert(res == OP_ParAppendResult::Success);
+	}
+
+	// Planar output
+	{
+		OP_StringParameter	sp;
+
+		sp.name = "Planaroutput";
+		sp.label = "Planar Output";
+		sp.defaultValue = "Triangles";
+
+		const char* names[] = { "Triangles", "Polygon" };
+		const char* labels[] = { "Triangles", "Polygon" };
+
+		OP_ParAppendResult res = manager->appendMenu(sp, 2, names, labels);
+		assert(res == OP_ParAppendResult::Success);
+	}
+
+	// Split by
+	{
+		OP_StringParameter	sp;
+
+		sp.name = "Splitby";
+		sp.label = "Split By";
+		sp.defaultValue = "None";
+
+		const char* names[] = { "None", "Connectivity", "Attribute" };
+		const char* labels[] = { "None", "Connectivity", "Attribute" };
+
+		OP_ParAppendResult res = manager->appendMenu(sp, 3, names, labels);
+		assert(res == OP_ParAppendResult::Success);
+	}
+
+	// Split attribute
+	{
+		OP_StringParameter	sp;
+
+		sp.name = "Splitattrib";
+		sp.label = "Split Attribute";
+		sp.defaultValue = "id";
+
+		OP_ParAppendResult res = manager->appendString(sp);
+		assert(res == OP_ParAppendResult::Success);
+	}
+
+	// Max vertices
+	{
+		OP_NumericParameter	np;
+
+		np.name = "Maxvertices";
+		np.label = "Max Vertices";
+		np.defaultValues[0] = 0;
+		np.minValues[0] = 0;
+		np.clampMins[0] = true;
+		np.minSliders[0] = 0;
+		np.maxSliders[0] = 1000;
+
+		OP_ParAppendResult res = manager->appendInt(np);
+		assert(res == OP_ParAppendResult::Success);
+	}
+
+	// Max faces
+	{
+		OP_NumericParameter	np;
+
+		np.name = "Maxfaces";
+		np.label = "Max Faces";
+		np.defaultValues[0] = 0;
+		np.minValues[0] = 0;
+		np.clampMins[0] = true;
+		np.minSliders[0] = 0;
+		np.maxSliders[0] = 2000;
+
+		OP_ParAppendResult res = manager->appendInt(np);
+		assert(res == OP_ParAppendResult::Success);
+	}
+
+	// Time budget
+	{
+		OP_NumericParameter	np;
+
+		np.name = "Timebudget";
+		np.label = "Time Budget (ms)";
+		np.defaultValues[0] = 0.0;
+		np.minValues[0] = 0.0;
+		np.clampMins[0] = true;
+		np.minSliders[0] = 0.0;
+		np.maxSliders[0] = 33.0;
+
+		OP_ParAppendResult res = manager->appendFloat(np);
+		assert(res == OP_ParAppendResult::Success);
+	}
+
+	// Threads
+	{
+		OP_NumericParameter	np;
+
+		np.name = "Threads";
+		np.label = "Threads";
+		np.defaultValues[0] = 1;
+		np.minValues[0] = 0;
+		np.clampMins[0] = true;
+		np.minSliders[0] = 0;
+		np.maxSliders[0] = 32;
+
+		OP_ParAppendResult res = manager->appendInt(np);
+		assert(res == OP_ParAppendResult::Success);
+	}
+
+	// Async
+	{
+		OP_NumericParameter	np;
+
+		np.name = "Async";
+		np.label = "Async";
+		np.defaultValues[0] = 0;
+
+		OP_ParAppendResult res = manager->appendToggle(np);
+		assert(res == OP_ParAppendResult::Success);
+	}
+
+	// Precision
+	{
+		OP_StringParameter	sp;
+
+		sp.name = "Precision";
+		sp.label = "Precision";
+		sp.defaultValue = "Float";
+
+		const char* names[] = { "Float", "Double" };
+		const char* labels[] = { "Float", "Double" };
+
+		OP_ParAppendResult res = manager->appendMenu(sp, 2, names, labels);
+		assert(res == OP_ParAppendResult::Success);
+	}
+
+	// Direct to GPU
+	{
+		OP_NumericParameter	np;
+
+		np.name = "Directtogpu";
+		np.label = "Direct to GPU";
+
+		OP_ParAppendResult res = manager->appendToggle(np);
+		assert(res == OP_ParAppendResult::Success);
+	}
+
+	// Trim after small cooks
+	{
+		OP_NumericParameter	np;
+
+		np.name = "Trimafter";
+		np.label = "Trim After Small Cooks";
+		np.defaultValues[0] = 0;
+		np.minValues[0] = 0;
+		np.clampMins[0] = true;
+		np.minSliders[0] = 0;
+		np.maxSliders[0] = 100;
+
+		OP_ParAppendResult res = manager->appendInt(np);
+		assert(res == OP_ParAppendResult::Success);
+	}
+
+	// Memory cap
+	{
+		OP_NumericParameter	np;
+
+		np.name = "Memorycap";
+		np.label = "Memory Cap (MB)";
+		np.defaultValues[0] = 0.0;
+		np.minValues[0] = 0.0;
+		np.clampMins[0] = true;
+		np.minSliders[0] = 0.0;
+		np.maxSliders[0] = 1024.0;
+
+		OP_ParAppendResult res = manager->appendFloat(np);
+		assert(res == OP_ParAppendResult::Success);
+	}
+
+	// Release memory
+	{
+		OP_NumericParameter	np;
+
+		np.name = "Releasememory";
+		np.label = "Release Memory";
+
+		OP_ParAppendResult res = manager->appendPulse(np);
+		assert(res == OP_ParAppendResult::Success);
+	}
+
+	// Trace
+	{
+		OP_NumericParameter	np;
+
+		np.name = "Trace";
+		np.label = "Trace";
+
+		OP_ParAppendResult res = manager->appendToggle(np);
+		assert(res == OP_ParAppendResult::Success);
+	}
+
+	// Trace file
+	{
+		OP_StringParameter	sp;
+
+		sp.name = "Tracefile";
+		sp.label = "Trace File";
+		sp.defaultValue = "convexhull_trace.json";
+
+		OP_ParAppendResult res = manager->appendFile(sp);
+		assert(res == OP_ParAppendResult::Success);
+	}
+
+}
+
+void
+ConvexHull::getWarningString(OP_String* warning, void* reserved)
+{
+	if (!myWarning.empty())
+		warning->setString(myWarning.c_str());
+	else if (!myTagWarning.empty())
+		warning->setString(myTagWarning.c_str());
+	else if (!myTraceWarning.empty())
+		warning->setString(myTraceWarning.c_str());
+	else if (!myMemoryWarning.empty())
+		warning->setString(myMemoryWarning.c_str());
+}
+
+void
+ConvexHull::pulsePressed(const char* name, void* reserved)
+{
+	if (!strcmp(name, "Releasememory"))
+		releaseMemory();
 }
 
@@ -15,10 +15,151 @@
 #pragma once
 
 #include "SOP_CPlusPlusBase.h"
+#include "AsyncWorker.h"
+#include "CookStats.h"
+#include "CookTrace.h"
+#include "CountingAllocator.h"
+#include "HullEngine.h"
+#include "InputSnapshot.h"
+#include "PlanarHull.h"
+#include "ThreadPool.h"
+#include <memory>
 #include <string>
+#include <vector>
 #include "quickhull/QuickHull.hpp"
 
 
+// How the input points are split into pieces that are hulled separately
+enum class SplitBy : int32_t
+{
+	None = 0,
+
+	// points connected by primitives
+	Connectivity,
+
+	// points with the same value of an integer custom attribute
+	Attribute,
+};
+
+// Which engine builds the hull
+enum class HullDimension : int32_t
+{
+	// the 2D engine for coplanar input, quickhull otherwise
+	Auto = 0,
+	ThreeD,
+
+	// always the 2D engine, on the points projected on the plane
+	TwoD,
+};
+
+// How a hull from the 2D engine is output
+enum class PlanarOutput : int32_t
+{
+	// a fan of triangles
+	Triangles = 0,
+
+	// a closed line strip
+	Polygon,
+};
+
+// What execute() outputs
+enum class OutputMode : int32_t
+{
+	// the hull mesh
+	Hull = 0,
+
+	// the input geometry as it is, with the hull points in the point group
+	// "hull" and the distance of every point to the hull in "hulldist"
+	TagInput,
+};
+
+// Normals the hull is output with
+enum class HullNormals : int32_t
+{
+	None = 0,
+
+	// one per point, the area weighted average of the faces around it
+	Point,
+
+	// every triangle has its own three points, with the normal of the face
+	// and its plane offset in "planeoffset"
+	Face,
+};
+
+// Everything the hull of a cook depends on. When two cooks have the same key
+// the hull of the previous one is output again instead of being recomputed.
+struct HullCacheKey
+{
+	int32_t		numPoints = 0;
+	uint64_t	hash = 0;
+	float		epsilon = 0.0f;
+	bool		ccw = false;
+	SplitBy		splitBy = SplitBy::None;
+	uint64_t	splitHash = 0;
+	HullDimension	dimension = HullDimension::Auto;
+	HullPlane	plane = HullPlane::Auto;
+	PlanarOutput	planarOutput = PlanarOutput::Triangles;
+	int32_t		maxVertices = 0;
+	Precision	precision = Precision::Float;
+
+	// the distances to the hull are only computed for OutputMode::TagInput.
+	// The time budget isn't part of the key: a hull cut short by it is never
+	// cached, and an exact one is the same for any budget.
+	bool		tagInput = false;
+
+	bool
+	operator==(const HullCacheKey& other) const
+	{
+		return numPoints == other.numPoints && hash == other.hash &&
+		       epsilon == other.epsilon && ccw == other.ccw &&
+		       splitBy == other.splitBy && splitHash == other.splitHash &&
+		       dimension == other.dimension && plane == other.plane &&
+		       planarOutput == other.planarOutput && maxVertices == other.maxVertices &&
+		       precision == other.precision && tagInput == other.tagInput;
+	}
+};
+
+// The parameters a hull is built with. They are read on the cook thread, so
+// that the build can run on another one.
+struct HullSettings
+{
+	float		epsilon = 0.0f;
+	bool		ccw = false;
+	SplitBy		splitBy = SplitBy::None;
+	std::string	splitAttrib;
+	HullDimension	dimension = HullDimension::Auto;
+	HullPlane	plane = HullPlane::Auto;
+	PlanarOutput	planarOutput = PlanarOutput::Triangles;
+	Precision	precision = Precision::Float;
+	bool		tagInput = false;
+
+	// vertex budget of the approximate hull, 0 means the exact hull
+	int32_t		maxVertices = 0;
+
+	// milliseconds the cook can take from the input fetch, 0 means no limit
+	float		timeBudget = 0.0f;
+
+	bool		cache = true;
+	int32_t		threads = 0;
+	bool		warmStart = false;
+	double		warmThreshold = 0.0;
+	bool		prefilter = false;
+
+	bool
+	operator==(const HullSettings& other) const
+	{
+		return epsilon == other.epsilon && ccw == other.ccw &&
+		       splitBy == other.splitBy && splitAttrib == other.splitAttrib &&
+		       dimension == other.dimension && plane == other.plane &&
+		       planarOutput == other.planarOutput && precision == other.precision &&
+		       tagInput == other.tagInput && maxVertices == other.maxVertices &&
+		       timeBudget == other.timeBudget && cache == other.cache && threads == other.threads &&
+		       warmStart == other.warmStart && warmThreshold == other.warmThreshold &&
+		       prefilter == other.prefilter;
+	}
+};
+
+
 // To get more help about these functions, look at SOP_CPlusPlusBase.h
 class ConvexHull : public SOP_CPlusPlusBase
 {
@@ -47,17 +188,409 @@ public:
 									OP_InfoDATEntries* entries,
 									void* reserved) override;
 
+	virtual void getWarningString(OP_String* warning, void* reserved) override;
+
 	virtual void setupParameters(OP_ParameterManager* manager, void* reserved) override;
 	virtual void pulsePressed(const char* name, void* reserved) override;
 
 private:
 
+	// A hull built on the worker thread in Async mode, with what the output
+	// and the Info CHOP need of it
+	struct AsyncResult
+	{
+		CountedVector<Position>	points;
+		CountedVector<int32_t>	indices;
+		CountedVector<int32_t>	lineIndices;
+		CountedVector<int32_t>	sourceIndices;
+		CountedVector<int32_t>	pieceIds;
+		CountedVector<float>	depths;
+
+		Vector					outlineNormal;
+		bool					tagInput = false;
+		bool					ccw = false;
+		bool					planar = false;
+		int32_t					inputPoints = 0;
+		int32_t					culledPoints = 0;
+		float					approxError = 0.0f;
+		bool					budgetExpired = false;
+		const char*				engine = "none";
+		std::string				warning;
+		HullCounters			counters;
+
+		// frame of the input it was built from, and its number among the
+		// results of the worker, from 1
+		int64_t					frame = 0;
+		int64_t					sequence = 0;
+	};
+
+	// Reads the parameters the hull is built with
+	void			readSettings(const OP_Inputs* inputs, HullSettings& settings) const;
+
+	// Brings myPoints/myIndices up to date for this cook, with a hull built
+	// right away or, in Async mode, the last one the worker finished.
+	// Returns false if there is nothing to output.
+	bool			updateHull(const OP_Inputs* inputs);
+
+	// Runs quickhull over the points of 'sinput' and stores the result in
+	// myPoints/myIndices. Returns false if there is nothing to output.
+	bool			computeHull(const HullSettings& settings, const OP_SOPInput* sinput);
+
+	// Async mode: takes the last hull the worker finished when it is new, and
+	// hands the worker a copy of the input unless it is still busy
+	bool			asyncHull(const OP_Inputs* inputs);
+
+	// Builds the hull of myAsyncInput with myAsyncBuilder into
+	// myAsyncResults[slot], on the worker thread
+	static void		runAsyncJob(void* context, int32_t slot);
+
+	// Copy the hull and its stats into a result, on the builder, and out of
+	// one, on the node
+	void			saveResult(AsyncResult& result);
+	void			loadResult(const AsyncResult& result);
+
+	// Bytes of the node's buffers, the async builder's included
+	int64_t			getMemoryBytes() const;
+
+	// Empties the hull buffers and invalidates the cache
+	void			clearHull();
+
+	// Builds the hull with the 2D engine. Unless 'force' is set, it is only
+	// done when the points are coplanar, false is returned otherwise.
+	// 'extremes' are the points of PointKernels::findExtremePoints(), here
+	// and for the bounded hull and the prefilter.
+	bool			planarHull(const Position* points, int32_t numPoints, const int32_t* extremes,
+							bool force, HullPlane plane, PlanarOutput planarOutput, bool ccw,
+							float epsilon);
+
+	// Builds an approximate hull with at most 'maxVertices' vertices by greedy
+	// furthest point insertion. Unless 'deadline' is nullptr, the insertion
+	// also stops once it has passed, which is checked every round and every
+	// BoundedScanBlock points of a round. Returns false when the input is too
+	// flat for it.
+	bool			boundedHull(const Position* points, int32_t numPoints, const int32_t* extremes,
+							bool ccw, float epsilon, int32_t maxVertices,
+							const CookTrace::Clock::time_point* deadline);
+
+	// True once myDeadline has passed, which is then kept in myBudgetExpired.
+	bool			budgetSpent();
+
+	// Ends the time budget of the cook. A hull it cut short isn't cached.
+	void			endBudget();
+
+	// Builds the hull from the current positions of last cook's hull vertices
+	// plus the points that are now outside of it. Returns false when that's not
+	// possible or when more than 'maxChange' of the points left the old hull,
+	// a full rebuild is needed then.
+	bool			warmStartHull(const Position* points, int32_t numPoints, bool ccw,
+							float epsilon, double maxChange);
+
+	// Fills myOutside with the points of 'points' that can be outside the hull
+	// 'indices' of mySubsetPoints, leaving out the points of the subset. The
+	// planes are built and tested relative to the subset's centroid, in double
+	// with Precision Double, and points closer to a plane than 'epsilon'
+	// times the subset's extent are kept. Returns false when the subset is flat.
+	bool			cullInside(const Position* points, int32_t numPoints,
+							const size_t* indices, size_t numTriangles, float epsilon);
+
+	// Drops the points that are inside the hull of the extreme points along
+	// a few fixed directions, then builds the hull of what is left.
+	// Returns false when the input is too small or too flat to cull anything.
+	bool			prefilterHull(const Position* points, int32_t numPoints, const int32_t* extremes,
+							bool ccw, float epsilon);
+
+	// Hulls 'numPoints' points and stores the result, on several threads when
+	// there are enough points. 'sourceIndices' is passed on to storeHull().
+	void			hullPoints(const Position* points, int32_t numPoints,
+							const int32_t* sourceIndices, bool ccw, float epsilon);
+
+	// hullPoints() with the quickhull instances of one precision
+	template<typename T>
+	void			hullPointsWith(HullEngine<T>& engine, const Position* points, int32_t numPoints,
+							const int32_t* sourceIndices, bool ccw, float epsilon);
 
+	// Hash of what the split into pieces depends on besides the positions:
+	// the primitives or the split attribute.
+	uint64_t		hashSplit(const OP_SOPInput* sinput, SplitBy splitBy, const char* splitAttrib);
+
+	// Groups the input points by piece into myPieceStarts/myPiecePoints and
+	// returns the number of pieces.
+	int32_t			splitPieces(const OP_SOPInput* sinput, SplitBy splitBy, const char* splitAttrib);
+
+	// Hulls every piece of the input on its own, in parallel, and stores all
+	// of them one after the other with their piece in myPieceIds.
+	void			hullPieces(const OP_SOPInput* sinput, SplitBy splitBy, const char* splitAttrib,
+							bool ccw, float epsilon);
+
+	// Hulls the pieces into myPieceHulls with the quickhull instances of one precision
+	template<typename T>
+	void			hullPiecesWith(HullEngine<T>& engine, const Position* points, int32_t numPieces,
+							bool ccw, float epsilon);
+
+	// Copies a hull built with original indices over 'points' into
+	// myPoints/myIndices. 'sourceIndices' maps 'points' to the input points,
+	// nullptr when 'points' is the input itself.
+	template<typename T>
+	void			storeHull(const quickhull::ConvexHull<T>& hull,
+							const Position* points, const int32_t* sourceIndices);
+
+	// Fills myHullDepths with the distance of every input point to the hull
+	// that was just built, positive inside
+	void			computeDepths(const Position* points, int32_t numPoints);
+
+	// Outputs the input geometry with the hull points in the group "hull" and
+	// myHullDepths in the attribute "hulldist", for OutputMode::TagInput.
+	// SOP_Output only takes triangles, so polygons with more vertices become
+	// fans of triangles and myTagWarning says so. The input only shows its
+	// polygons, its lines and particles aren't passed on, only their points.
+	void			emitTaggedInput(const OP_SOPInput* sinput, bool attributes, SOP_Output* output);
+
+	// Copies the point attributes of the input (normals, colors, texture
+	// coordinates and custom attributes) onto the output points, point i
+	// taking the values of the input point sources[i]
+	void			carryAttributes(const OP_SOPInput* sinput, const int32_t* sources,
+							int32_t numPoints, SOP_Output* output);
+
+	// Same for the VBOs, without the normals that are computed from the hull:
+	// enableCarriedAttributes() is called before allocVBO() and
+	// carryAttributes() after it
+	void			enableCarriedAttributes(const OP_SOPInput* sinput, SOP_VBOOutput* output);
+	void			carryAttributes(const OP_SOPInput* sinput, const int32_t* sources,
+							int32_t numPoints, SOP_VBOOutput* output);
+
+	// Writes the area weighted normal of every hull point to 'normals'. The
+	// points of a planar outline, which has no faces, get the plane normal.
+	void			buildPointNormals(bool ccw, Vector* normals) const;
+
+	// Fills the myFacet* buffers with the hull as separate triangles, three
+	// points each, for HullNormals::Face. 'sources' also fills
+	// myFacetSources for the attributes.
+	void			buildFacets(bool ccw, bool sources);
+
+	// Opens or closes the trace file as the Trace parameters say. The spans
+	// are the node's stages, a quickhull build is one span without its phases.
+	void			updateTrace(const OP_Inputs* inputs);
+
+	// Adds the cook that just ended to myCookStats, and to the trace
+	void			recordCook();
+
+	// Releases the scratch memory at the end of a cook when the trim policy
+	// of the parameters asks for it
+	void			trimMemory(const OP_Inputs* inputs);
+
+	// Frees the scratch buffers and the quickhull instances. The hull is
+	// kept, so the cache and the warm start still work.
+	void			releaseMemory();
 
 	// We don't need to store this pointer, but we do for the example.
 	// The OP_NodeInfo class store information about the node that's using
 	// this instance of the class (like its name).
 	const OP_NodeInfo*		myNodeInfo;
 
+	// counts the memory of the buffers below (CountedVector), it has to
+	// outlive them
+	AllocationCounter		myMemory;
+
+	// quickhull for the float only culling steps (warm start seed, prefilter
+	// polytope, bounded hull rounds)
 	quickhull::QuickHull<float> qh;
+
+	// quickhull instances the stored hull is built with, per precision
+	Precision				myPrecision;
+	HullEngine<float>		myFloatHulls;
+	HullEngine<double>		myDoubleHulls;
+
+	// quickhull runs of the current cook, both engines and qh
+	HullCounters			myHullCounters;
+
+	// points and triangle indices of the last hull, indices are narrowed to
+	// int32_t as that's what SOP_Output and SOP_VBOOutput take
+	CountedVector<Position>	myPoints;
+	CountedVector<int32_t>	myIndices;
+
+	// closed line strip of a planar hull output as a polygon
+	CountedVector<int32_t>	myLineIndices;
+
+	// index of the input point each hull point comes from
+	CountedVector<int32_t>	mySourceIndices;
+
+	// scratch used to compact the hull, kept filled with -1 between cooks
+	CountedVector<int32_t>	myRemap;
+
+	// distance of every input point to the hull, when it is output with the
+	// input geometry
+	bool					myTagInput;
+	CountedVector<float>	myHullDepths;
+
+	// triangle vertex order the hull was built with, an async hull can be
+	// older than the Ccw parameter
+	bool					myCcw;
+
+	// input attributes gathered for the hull points, the custom attribute
+	// buffers are reused by every attribute
+	CountedVector<Vector>	myCarryNormals;
+	CountedVector<Color>	myCarryColors;
+	CountedVector<TexCoord>	myCarryTexCoords;
+	CountedVector<float>	myCarryFloats;
+	CountedVector<int32_t>	myCarryInts;
+
+	// the hull as separate triangles, with per face normals and plane
+	// offsets. myFacetIndices is 0, 1, 2, ... and only grows.
+	CountedVector<Position>	myFacetPoints;
+	CountedVector<int32_t>	myFacetIndices;
+	CountedVector<int32_t>	myFacetSources;
+	CountedVector<int32_t>	myFacetPieceIds;
+	CountedVector<float>	myFaceOffsets;
+
+	// normals of the output points, of the hull points or of the facets
+	CountedVector<Vector>	myEmitNormals;
+
+	// frame of the last executeVBO() call, used to detect animated input
+	int64_t					myLastVBOFrame;
+
+	// key of the hull currently in myPoints/myIndices
+	HullCacheKey			myCacheKey;
+	bool					myCacheValid;
+
+	int64_t					myCacheHits;
+	int64_t					myCacheMisses;
+
+	// point count of the input the current hull was built from
+	int32_t					myWarmNumPoints;
+
+	// scratch for the warm start and the prefilter: the reduced point set given
+	// to quickhull and the input index of each of its points
+	CountedVector<Position>	mySubsetPoints;
+	CountedVector<int32_t>	mySubsetSources;
+	CountedVector<float>	myPlanes;
+	CountedVector<double>	myDoublePlanes;
+	CountedVector<int32_t>	myOutside;
+
+	int64_t					myWarmStarts;
+	int64_t					myWarmFallbacks;
+
+	// points that didn't go through the full quickhull in the last build
+	int32_t					myCulledPoints;
+
+	// parallel build: one vertex list per slice, and the merged slice
+	// vertices that go through the last quickhull run
+	int32_t					myNumThreads;
+	std::unique_ptr<ThreadPool>	myThreadPool;
+	CountedVector<CountedVector<int32_t>>	myChunkVertices;
+	CountedVector<Position>	myMergePoints;
+	CountedVector<int32_t>	myMergeSources;
+
+	// vertex count of every input primitive, for the connectivity hash
+	CountedVector<int32_t>	myPrimSizes;
+
+	// per piece hulls: the piece of every input point, the point indices
+	// grouped by piece, and the hull of each piece. Entries past the piece
+	// count are kept from earlier cooks for their memory.
+	struct PieceHull
+	{
+		CountedVector<Position>	points;
+		CountedVector<int32_t>	indices;
+		CountedVector<int32_t>	sources;
+	};
+
+	struct SlotScratch
+	{
+		CountedVector<Position>	points;
+		CountedVector<int32_t>	remap;
+		CountedVector<float>	planes;
+		CountedVector<float>	depths;
+
+		// extreme points of a piece hulled past the deadline
+		CountedVector<Position>	extremePoints;
+		CountedVector<int32_t>	extremeSources;
+	};
+
+	CountedVector<int32_t>	myPieceLabels;
+	CountedVector<int32_t>	myPieceValues;
+	CountedVector<int32_t>	myPieceStarts;
+	CountedVector<int32_t>	myPieceFill;
+	CountedVector<int32_t>	myPiecePoints;
+	CountedVector<PieceHull>	myPieceHulls;
+	CountedVector<SlotScratch>	mySlotScratch;
+
+	// piece of each hull point, empty when the input isn't split
+	CountedVector<int32_t>	myPieceIds;
+
+	std::string				myWarning;
+
+	// 2D engine for coplanar input, and the normal of the last planar hull
+	PlanarHull				myPlanarHull;
+	bool					myPlanar;
+	Vector					myOutlineNormal;
+
+	// scratch of the bounded hull, and the error bound of the last one
+	CountedVector<Position>	myCandidatePoints;
+	CountedVector<int32_t>	myCandidateSources;
+	CountedVector<int32_t>	myFurthest;
+	CountedVector<float>	myFurthestDistances;
+	CountedVector<int32_t>	myBlockFurthest;
+	CountedVector<float>	myBlockDistances;
+	CountedVector<int32_t>	myFurthestPlanes;
+	CountedVector<size_t>	myHullVertices;
+	float					myApproxError;
+
+	// the time budget ran out before the hull was complete, and when it
+	// runs out, the end of time without a budget
+	bool					myBudgetExpired;
+	CookTrace::Clock::time_point	myDeadline;
+
+	// stage timings of the last cook in milliseconds, and its input size
+	float					myFetchMs;
+	float					myBuildMs;
+	float					myEmitMs;
+	int32_t					myInputPoints;
+
+	// path that produced the last hull, and the last cooks for the Info DAT
+	const char*				myEngine;
+	CookStats				myCookStats;
+
+	// trim policy: the largest input since the memory was last released, the
+	// small cooks in a row since then, and how many times it was released
+	int32_t					myLargestInput;
+	int32_t					mySmallCooks;
+	int64_t					myMemoryReleases;
+
+	// memory cap: the bytes a release left, at which cap and input size. A
+	// release can't go below them, so a smaller cap isn't released for.
+	int64_t					myKeptBytes;
+	double					myKeptCap;
+	int32_t					myKeptPoints;
+	std::string				myMemoryWarning;
+
+	// spans of the cook stages when tracing, and when the cook started
+	CookTrace				myTrace;
+	std::string				myTraceWarning;
+
+	// set when Tag Input Points turned polygons into triangles
+	std::string				myTagWarning;
+	CookTrace::Clock::time_point	myCookStart;
+
+	// parameters of the hull built on the cook thread
+	HullSettings			mySettings;
+
+	// Async mode: the worker builds with a node of its own, so none of the
+	// build state is shared with the cook thread. The input copy and its
+	// settings are only written while the worker isn't busy, the results
+	// are read from the slot it published last.
+	std::unique_ptr<ConvexHull>	myAsyncBuilder;
+	InputSnapshot			myAsyncInput;
+	HullSettings			myAsyncSettings;
+	int64_t					myAsyncFrame;
+	bool					myAsyncSubmitted;
+	AsyncResult				myAsyncResults[2];
+
+	// results made by the worker, the one in myPoints and its input frame
+	int64_t					myAsyncSequence;
+	int64_t					myAsyncTaken;
+	int64_t					myAsyncTakenFrame;
+
+	// frames between the input of the hull output and the current one
+	int64_t					myAsyncAge;
+
+	std::unique_ptr<AsyncWorker>	myAsyncWorker;
 };
@@ -0,0 +1,66 @@
+#include "CookStats.h"
+
+#include <algorithm>
+#include <math.h>
+
+CookStats::CookStats() :
+	myNext(0),
+	myNumCooks(0),
+	mySortedValid(false)
+{
+	myRecords.reserve(WindowSize);
+}
+
+void
+CookStats::add(const CookRecord& record)
+{
+	myNumCooks++;
+
+	if (static_cast<int32_t>(myRecords.size()) < WindowSize)
+		myRecords.push_back(record);
+	else
+		myRecords[myNext] = record;
+
+	myRecords[myNext].cook = myNumCooks;
+	myNext = (myNext + 1) % WindowSize;
+	mySortedValid = false;
+}
+
+int32_t
+CookStats::getCount() const
+{
+	return static_cast<int32_t>(myRecords.size());
+}
+
+const CookRecord&
+CookStats::getRecent(int32_t i) const
+{
+	int32_t count = getCount();
+
+	return myRecords[((myNext - 1 - i) % count + count) % count];
+}
+
+float
+CookStats::getPercentile(float percent)
+{
+	if (myRecords.empty())
+		return 0.0f;
+
+	if (!mySortedValid)
+	{
+		mySorted.clear();
+
+		for (const CookRecord& record : myRecords)
+		{
+			mySorted.push_back(record.milliseconds);
+		}
+
+		std::sort(mySorted.begin(), mySorted.end());
+		mySortedValid = true;
+	}
+
+	int32_t count = static_cast<int32_t>(mySorted.size());
+	int32_t rank = static_cast<int32_t>(ceilf(percent / 100.0f * count));
+
+	return mySorted[std::min(std::max(rank, 1), count) - 1];
+}
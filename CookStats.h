@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+// What the Info DAT shows about one cook
+struct CookRecord
+{
+	int64_t		cook = 0;
+	int32_t		inputPoints = 0;
+	int32_t		hullVertices = 0;
+	int32_t		hullFaces = 0;
+
+	// static string naming the path that produced the hull
+	const char*	engine = "";
+
+	float		milliseconds = 0.0f;
+};
+
+// Rolling window of the last cooks, for the latency percentiles and the
+// table of recent cooks of the Info DAT.
+class CookStats
+{
+public:
+
+	static const int32_t	WindowSize = 256;
+
+	CookStats();
+
+	// Adds a cook, dropping the oldest one once the window is full.
+	// record.cook is filled with the number of cooks seen so far.
+	void				add(const CookRecord& record);
+
+	// Number of cooks in the window
+	int32_t				getCount() const;
+
+	// Cooks in the window, 0 is the most recent
+	const CookRecord&	getRecent(int32_t i) const;
+
+	// Returns the smallest latency that 'percent' of the cooks in the window
+	// did not exceed (nearest rank), 0 when the window is empty.
+	float				getPercentile(float percent);
+
+private:
+
+	std::vector<CookRecord>	myRecords;
+	int32_t					myNext;
+	int64_t					myNumCooks;
+
+	// latencies of the window in increasing order, sorted on demand
+	std::vector<float>		mySorted;
+	bool					mySortedValid;
+};
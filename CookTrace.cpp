@@ -0,0 +1,193 @@
+#include "CookTrace.h"
+
+CookTrace::CookTrace() :
+	myFile(nullptr),
+	myOpen(false)
+{
+}
+
+CookTrace::~CookTrace()
+{
+	close();
+}
+
+bool
+CookTrace::open(const char* path)
+{
+	std::lock_guard<std::mutex> lock(myMutex);
+
+	if (myFile && myPath == path)
+		return true;
+
+	closeFile();
+
+	myFile = fopen(path, "w");
+
+	if (!myFile)
+		return false;
+
+	myPath = path;
+	myStart = Clock::now();
+	myThreadIds.clear();
+
+	fputs("[\n", myFile);
+
+	myOpen = true;
+
+	return true;
+}
+
+void
+CookTrace::close()
+{
+	if (!myOpen)
+		return;
+
+	std::lock_guard<std::mutex> lock(myMutex);
+
+	closeFile();
+}
+
+bool
+CookTrace::isOpen() const
+{
+	return myOpen.load(std::memory_order_relaxed);
+}
+
+void
+CookTrace::addSpan(const char* name, Clock::time_point start, const char* args)
+{
+	if (!isOpen())
+		return;
+
+	Clock::time_point end = Clock::now();
+
+	char event[256];
+	std::lock_guard<std::mutex> lock(myMutex);
+
+	// the async worker adds spans while the cook thread may close the file
+	if (!myFile)
+		return;
+
+	double ts = std::chrono::duration<double, std::micro>(start - myStart).count();
+	double dur = std::chrono::duration<double, std::micro>(end - start).count();
+
+	snprintf(event, sizeof(event),
+	         "{\"name\": \"%s\", \"cat\": \"cook\", \"ph\": \"X\", \"pid\": 1, \"tid\": %d, \"ts\": %.3f, \"dur\": %.3f",
+	         name, getThreadId(), ts, dur);
+
+	myPending += event;
+
+	if (args && args[0])
+	{
+		myPending += ", \"args\": {";
+		myPending += args;
+		myPending += "}";
+	}
+
+	myPending += "},\n";
+}
+
+void
+CookTrace::flush()
+{
+	if (!isOpen())
+		return;
+
+	std::lock_guard<std::mutex> lock(myMutex);
+
+	if (!myFile)
+		return;
+
+	fputs(myPending.c_str(), myFile);
+	fflush(myFile);
+
+	myPending.clear();
+}
+
+void
+CookTrace::closeFile()
+{
+	// called with myMutex held
+	if (!myFile)
+		return;
+
+	fputs(myPending.c_str(), myFile);
+	fclose(myFile);
+
+	myFile = nullptr;
+	myOpen = false;
+	myPath.clear();
+	myPending.clear();
+}
+
+int32_t
+CookTrace::getThreadId()
+{
+	// called with myMutex held
+	std::thread::id id = std::this_thread::get_id();
+
+	auto it = myThreadIds.find(id);
+
+	if (it != myThreadIds.end())
+		return it->second;
+
+	int32_t traceId = static_cast<int32_t>(myThreadIds.size());
+	myThreadIds[id] = traceId;
+
+	// name the thread in the viewer
+	char event[128];
+	snprintf(event, sizeof(event),
+	         "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %d, \"args\": {\"name\": \"%s %d\"}},\n",
+	         traceId, traceId == 0 ? "cook" : "worker", traceId);
+
+	myPending += event;
+
+	return traceId;
+}
+
+TraceSpan::TraceSpan(CookTrace& trace, const char* name) :
+	myTrace(trace),
+	myName(name),
+	myActive(trace.isOpen())
+{
+	if (myActive)
+		myStart = CookTrace::Clock::now();
+}
+
+TraceSpan::~TraceSpan()
+{
+	if (myActive)
+		myTrace.addSpan(myName, myStart, myArgs.c_str());
+}
+
+void
+TraceSpan::addArg(const char* name, int64_t value)
+{
+	if (!myActive)
+		return;
+
+	if (!myArgs.empty())
+		myArgs += ", ";
+
+	myArgs += "\"";
+	myArgs += name;
+	myArgs += "\": ";
+	myArgs += std::to_string(value);
+}
+
+void
+TraceSpan::addArg(const char* name, const char* value)
+{
+	if (!myActive)
+		return;
+
+	if (!myArgs.empty())
+		myArgs += ", ";
+
+	myArgs += "\"";
+	myArgs += name;
+	myArgs += "\": \"";
+	myArgs += value;
+	myArgs += "\"";
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Writes spans of the cook stages to a Chrome trace file (JSON array format)
+// that chrome://tracing and ui.perfetto.dev open. Spans are written at the
+// end of every cook and the array is left open, which both viewers accept,
+// so the file can be loaded while the node keeps cooking.
+class CookTrace
+{
+public:
+
+	typedef std::chrono::steady_clock	Clock;
+
+	CookTrace();
+
+	~CookTrace();
+
+	// Starts a new trace in 'path', unless it is already the open one.
+	// Returns false if the file can't be created.
+	bool			open(const char* path);
+
+	// Writes the pending spans and closes the file. Like addSpan(), open(),
+	// close() and isOpen() are thread safe: the async worker adds spans while
+	// the cook thread may close the trace.
+	void			close();
+
+	// Doesn't take the lock, so spans cost a load when there is no trace
+	bool			isOpen() const;
+
+	// Records a span from 'start' to now on the calling thread. 'args' is
+	// the inside of a JSON object, e.g. "\"points\": 12", or nullptr.
+	// Thread safe.
+	void			addSpan(const char* name, Clock::time_point start, const char* args = nullptr);
+
+	// Writes the spans recorded since the last call to the file
+	void			flush();
+
+private:
+
+	// Writes the pending spans and closes the file
+	void			closeFile();
+
+	// Trace id of the calling thread, threads are numbered in the order they
+	// add their first span
+	int32_t			getThreadId();
+
+	FILE*			myFile;
+	std::string		myPath;
+	Clock::time_point	myStart;
+
+	mutable std::mutex	myMutex;
+	std::string		myPending;
+
+	// set while myFile is, read without myMutex
+	std::atomic<bool>	myOpen;
+
+	std::map<std::thread::id, int32_t>	myThreadIds;
+};
+
+// Adds a span to a trace from its construction to its destruction, when the
+// trace is open
+class TraceSpan
+{
+public:
+
+	TraceSpan(CookTrace& trace, const char* name);
+
+	~TraceSpan();
+
+	// Adds an argument shown with the span
+	void			addArg(const char* name, int64_t value);
+	void			addArg(const char* name, const char* value);
+
+private:
+
+	CookTrace&		myTrace;
+	const char*		myName;
+	bool			myActive;
+
+	CookTrace::Clock::time_point	myStart;
+	std::string		myArgs;
+};
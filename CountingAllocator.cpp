@@ -0,0 +1,74 @@
+#include "CountingAllocator.h"
+
+namespace
+{
+	thread_local AllocationCounter*	theCurrentCounter = nullptr;
+}
+
+AllocationCounter::AllocationCounter() :
+	myCurrentBytes(0),
+	myPeakBytes(0),
+	myAllocations(0)
+{
+}
+
+void
+AllocationCounter::add(size_t bytes)
+{
+	int64_t current = myCurrentBytes.fetch_add(static_cast<int64_t>(bytes)) + static_cast<int64_t>(bytes);
+	int64_t peak = myPeakBytes.load();
+
+	while (current > peak && !myPeakBytes.compare_exchange_weak(peak, current))
+	{
+	}
+
+	myAllocations++;
+}
+
+void
+AllocationCounter::remove(size_t bytes)
+{
+	myCurrentBytes.fetch_sub(static_cast<int64_t>(bytes));
+}
+
+void
+AllocationCounter::beginCook()
+{
+	myPeakBytes.store(myCurrentBytes.load());
+	myAllocations.store(0);
+}
+
+int64_t
+AllocationCounter::getCurrentBytes() const
+{
+	return myCurrentBytes.load();
+}
+
+int64_t
+AllocationCounter::getPeakBytes() const
+{
+	return myPeakBytes.load();
+}
+
+int64_t
+AllocationCounter::getAllocations() const
+{
+	return myAllocations.load();
+}
+
+AllocationScope::AllocationScope(AllocationCounter& counter) :
+	myPrevious(theCurrentCounter)
+{
+	theCurrentCounter = &counter;
+}
+
+AllocationScope::~AllocationScope()
+{
+	theCurrentCounter = myPrevious;
+}
+
+AllocationCounter*
+AllocationScope::getCurrent()
+{
+	return theCurrentCounter;
+}
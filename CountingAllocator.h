@@ -0,0 +1,124 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <new>
+#include <vector>
+
+// Bytes held by the buffers of one node, for its memory channels
+class AllocationCounter
+{
+public:
+
+	AllocationCounter();
+
+	void		add(size_t bytes);
+	void		remove(size_t bytes);
+
+	// Restarts the peak from the current bytes and the allocation count from 0
+	void		beginCook();
+
+	int64_t		getCurrentBytes() const;
+	int64_t		getPeakBytes() const;
+	int64_t		getAllocations() const;
+
+private:
+
+	std::atomic<int64_t>	myCurrentBytes;
+	std::atomic<int64_t>	myPeakBytes;
+	std::atomic<int64_t>	myAllocations;
+};
+
+// Makes CountingAllocator count the allocations of the calling thread with
+// 'counter' until the scope ends. Scopes nest.
+class AllocationScope
+{
+public:
+
+	explicit AllocationScope(AllocationCounter& counter);
+
+	~AllocationScope();
+
+	// Counter of the innermost scope on this thread, nullptr outside of one
+	static AllocationCounter*	getCurrent();
+
+private:
+
+	AllocationCounter*	myPrevious;
+};
+
+// Allocator that counts its blocks with the counter of the scope they were
+// allocated in. Every block remembers its counter, so it can be freed from
+// any thread, in any scope or in none.
+template<typename T>
+class CountingAllocator
+{
+public:
+
+	typedef T	value_type;
+
+	CountingAllocator() = default;
+
+	template<typename U>
+	CountingAllocator(const CountingAllocator<U>&)
+	{
+	}
+
+	T*
+	allocate(size_t n)
+	{
+		size_t bytes = n * sizeof(T);
+		char* block = static_cast<char*>(::operator new(bytes + HeaderSize));
+
+		Header* header = reinterpret_cast<Header*>(block);
+		header->counter = AllocationScope::getCurrent();
+		header->bytes = bytes;
+
+		if (header->counter)
+			header->counter->add(bytes);
+
+		return reinterpret_cast<T*>(block + HeaderSize);
+	}
+
+	void
+	deallocate(T* p, size_t)
+	{
+		char* block = reinterpret_cast<char*>(p) - HeaderSize;
+		Header* header = reinterpret_cast<Header*>(block);
+
+		if (header->counter)
+			header->counter->remove(header->bytes);
+
+		::operator delete(block);
+	}
+
+	template<typename U>
+	bool operator==(const CountingAllocator<U>&) const { return true; }
+
+	template<typename U>
+	bool operator!=(const CountingAllocator<U>&) const { return false; }
+
+private:
+
+	struct Header
+	{
+		AllocationCounter*	counter;
+		size_t				bytes;
+	};
+
+	// keeps the alignment operator new gives
+	static const size_t		HeaderSize = 16;
+};
+
+// Vector whose memory is counted, for the buffers of the node
+template<typename T>
+using CountedVector = std::vector<T, CountingAllocator<T>>;
+
+// Frees the memory of 'buffer', which clear() keeps
+template<typename T>
+inline void
+freeBuffer(CountedVector<T>& buffer)
+{
+	CountedVector<T>().swap(buffer);
+}
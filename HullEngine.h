@@ -0,0 +1,156 @@
+#pragma once
+
+#include "CPlusPlus_Common.h"
+#include "PointKernels.h"
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+#include "quickhull/QuickHull.hpp"
+
+// Floating point type quickhull runs in
+enum class Precision : int32_t
+{
+	Float = 0,
+
+	// slower, for inputs far from the origin
+	Double,
+};
+
+// What quickhull runs did, summed over the runs of a cook. Only what goes in
+// and out of a run is counted, quickhull has no hooks into its build: its
+// iterations, the points it assigns to each face, its horizon edges, the
+// faces it reuses, disables and deletes and the points it rejects within
+// epsilon are out of reach without patching the submodule, which the node
+// doesn't do. Its diagnostics only give the failed horizon edges.
+struct HullCounters
+{
+	int64_t		runs = 0;
+
+	// points given to quickhull
+	int64_t		points = 0;
+
+	// faces of the hulls it returned
+	int64_t		faces = 0;
+
+	// horizon edges quickhull couldn't close, from its diagnostics
+	int64_t		failedHorizonEdges = 0;
+
+	void
+	add(const HullCounters& other)
+	{
+		runs += other.runs;
+		points += other.points;
+		faces += other.faces;
+		failedHorizonEdges += other.failedHorizonEdges;
+	}
+
+	// Adds the run of 'qh' that returned 'hull' from 'numPoints' points
+	template<typename T>
+	void
+	addRun(quickhull::QuickHull<T>& qh, const quickhull::ConvexHull<T>& hull, size_t numPoints)
+	{
+		runs++;
+		points += static_cast<int64_t>(numPoints);
+		faces += static_cast<int64_t>(hull.getIndexBuffer().size() / 3);
+		failedHorizonEdges += static_cast<int64_t>(qh.getDiagnostics().m_failedHorizonEdges);
+	}
+};
+
+// quickhull instances of one precision, one per thread slot. Slot 0 is the
+// one used outside of parallel sections. The SOP hands out float positions,
+// the double instances convert them into a per slot buffer on the way in.
+template<typename T>
+class HullEngine
+{
+public:
+
+	// Makes sure slots 0 to numSlots - 1 exist. Not thread safe, it must be
+	// called before a parallel section uses the slots.
+	void
+	reserve(int32_t numSlots)
+	{
+		while (static_cast<int32_t>(myHulls.size()) < numSlots)
+		{
+			myHulls.emplace_back(new quickhull::QuickHull<T>());
+		}
+
+		if (static_cast<int32_t>(myScratch.size()) < numSlots)
+			myScratch.resize(numSlots);
+
+		if (static_cast<int32_t>(myCounters.size()) < numSlots)
+			myCounters.resize(numSlots);
+	}
+
+	// Frees the quickhull instances, whose internal buffers stay as big as
+	// the largest input they hulled, and the scratch. The counters are kept.
+	void
+	release()
+	{
+		myHulls.clear();
+		myScratch.clear();
+	}
+
+	// Hulls 'numPoints' positions with the instance of 'slot', keeping the
+	// original indices. The result must be used before the slot runs again.
+	// Different slots can run at the same time.
+	quickhull::ConvexHull<T>	build(int32_t slot, const Position* points, int32_t numPoints,
+								bool ccw, float epsilon);
+
+	// Returns the counters of the runs since the last call, and restarts them
+	HullCounters
+	takeCounters()
+	{
+		HullCounters total;
+
+		for (HullCounters& counters : myCounters)
+		{
+			total.add(counters);
+			counters = HullCounters();
+		}
+
+		return total;
+	}
+
+private:
+
+	std::vector<std::unique_ptr<quickhull::QuickHull<T>>>	myHulls;
+	std::vector<CountedVector<T>>							myScratch;
+
+	// counters of the runs of each slot
+	std::vector<HullCounters>								myCounters;
+};
+
+// Position is 3 packed floats, quickhull reads it in place
+template<>
+inline quickhull::ConvexHull<float>
+HullEngine<float>::build(int32_t slot, const Position* points, int32_t numPoints,
+						bool ccw, float epsilon)
+{
+	quickhull::ConvexHull<float> hull = myHulls[slot]->getConvexHull(
+	                                        reinterpret_cast<const float*>(points),
+	                                        numPoints, ccw, true, epsilon);
+
+	myCounters[slot].addRun(*myHulls[slot], hull, numPoints);
+
+	return hull;
+}
+
+template<>
+inline quickhull::ConvexHull<double>
+HullEngine<double>::build(int32_t slot, const Position* points, int32_t numPoints,
+						bool ccw, float epsilon)
+{
+	CountedVector<double>& scratch = myScratch[slot];
+	scratch.resize(static_cast<size_t>(numPoints) * 3);
+
+	PointKernels::toDouble(points, numPoints, scratch.data());
+
+	quickhull::ConvexHull<double> hull = myHulls[slot]->getConvexHull(
+	                                         scratch.data(), numPoints, ccw, true,
+	                                         static_cast<double>(epsilon));
+
+	myCounters[slot].addRun(*myHulls[slot], hull, numPoints);
+
+	return hull;
+}
@@ -0,0 +1,167 @@
+#include "InputSnapshot.h"
+
+InputSnapshot::InputSnapshot() :
+	myHasAttribute(false)
+{
+	opPath = nullptr;
+	opId = 0;
+	myPrimsInfo = nullptr;
+	myPrimPointIndices = nullptr;
+	totalCooks = 0;
+}
+
+void
+InputSnapshot::copy(const OP_SOPInput* input, bool primitives, const char* attribName)
+{
+	int32_t numPoints = input->getNumPoints();
+
+	// the path belongs to the input, it isn't kept
+	opId = input->opId;
+	totalCooks = input->totalCooks;
+
+	myPositions.assign(input->getPointPositions(), input->getPointPositions() + numPoints);
+
+	myPrimitives.clear();
+	myVertices.clear();
+
+	if (primitives)
+	{
+		int32_t numPrims = input->getNumPrimitives();
+
+		myVertices.assign(input->myPrimPointIndices, input->myPrimPointIndices + input->getNumVertices());
+		myPrimitives.resize(numPrims);
+
+		for (int32_t i = 0; i < numPrims; i++)
+		{
+			myPrimitives[i] = input->getPrimitive(i);
+			myPrimitives[i].pointIndices = myVertices.data() + myPrimitives[i].pointIndicesOffset;
+		}
+	}
+
+	myPrimsInfo = myPrimitives.data();
+	myPrimPointIndices = myVertices.data();
+
+	const SOP_CustomAttribData* attrib = attribName ? input->getCustomAttribute(attribName) : nullptr;
+
+	myHasAttribute = attrib != nullptr;
+
+	if (myHasAttribute)
+	{
+		size_t size = static_cast<size_t>(numPoints) * attrib->numComponents;
+
+		myAttributeName = attrib->name;
+		myAttribute = SOP_CustomAttribData(myAttributeName.c_str(), attrib->numComponents, attrib->attribType);
+
+		if (attrib->attribType == AttribType::Float)
+		{
+			myAttributeFloats.assign(attrib->floatData, attrib->floatData + size);
+			myAttribute.floatData = myAttributeFloats.data();
+		}
+		else
+		{
+			myAttributeInts.assign(attrib->intData, attrib->intData + size);
+			myAttribute.intData = myAttributeInts.data();
+		}
+	}
+}
+
+void
+InputSnapshot::release()
+{
+	freeBuffer(myPositions);
+	freeBuffer(myPrimitives);
+	freeBuffer(myVertices);
+	freeBuffer(myAttributeFloats);
+	freeBuffer(myAttributeInts);
+
+	myPrimsInfo = nullptr;
+	myPrimPointIndices = nullptr;
+	myHasAttribute = false;
+}
+
+int32_t
+InputSnapshot::getNumPoints() const
+{
+	return static_cast<int32_t>(myPositions.size());
+}
+
+int32_t
+InputSnapshot::getNumVertices() const
+{
+	return static_cast<int32_t>(myVertices.size());
+}
+
+int32_t
+InputSnapshot::getNumPrimitives() const
+{
+	return static_cast<int32_t>(myPrimitives.size());
+}
+
+int32_t
+InputSnapshot::getNumCustomAttributes() const
+{
+	return myHasAttribute ? 1 : 0;
+}
+
+const Position*
+InputSnapshot::getPointPositions() const
+{
+	return myPositions.data();
+}
+
+const SOP_NormalInfo*
+InputSnapshot::getNormals() const
+{
+	return nullptr;
+}
+
+const SOP_ColorInfo*
+InputSnapshot::getColors() const
+{
+	return nullptr;
+}
+
+const SOP_TextureInfo*
+InputSnapshot::getTextures() const
+{
+	return nullptr;
+}
+
+const SOP_CustomAttribData*
+InputSnapshot::getCustomAttribute(int32_t customAttribIndex) const
+{
+	return myHasAttribute && customAttribIndex == 0 ? &myAttribute : nullptr;
+}
+
+const SOP_CustomAttribData*
+InputSnapshot::getCustomAttribute(const char* customAttribName) const
+{
+	if (!myHasAttribute || !customAttribName || myAttributeName != customAttribName)
+		return nullptr;
+
+	return &myAttribute;
+}
+
+bool
+InputSnapshot::hasNormals() const
+{
+	return false;
+}
+
+bool
+InputSnapshot::hasColors() const
+{
+	return false;
+}
+
+bool
+InputSnapshot::isInside(const Position&)
+{
+	return false;
+}
+
+bool
+InputSnapshot::sendRay(const Position&, const Vector&, Position&, float&, Vector&, float&, float&, int&)
+{
+	return false;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <string>
+
+#include "CPlusPlus_Common.h"
+#include "CountingAllocator.h"
+
+// Copy of the parts of a SOP input a hull is built from: the point positions,
+// and the primitives or the custom attribute the points are split by. Unlike
+// the input it stays valid after the cook, for a build on another thread.
+class InputSnapshot : public OP_SOPInput
+{
+public:
+
+	InputSnapshot();
+
+	// Copies the points of 'input', its primitives when 'primitives' is true
+	// and its custom attribute 'attribName' when it isn't nullptr
+	void			copy(const OP_SOPInput* input, bool primitives, const char* attribName);
+
+	// Frees the copied data
+	void			release();
+
+	virtual int32_t	getNumPoints() const override;
+	virtual int32_t	getNumVertices() const override;
+	virtual int32_t	getNumPrimitives() const override;
+	virtual int32_t	getNumCustomAttributes() const override;
+
+	virtual const Position*	getPointPositions() const override;
+
+	// only what the hull uses is copied, the other attributes are missing
+	virtual const SOP_NormalInfo*	getNormals() const override;
+	virtual const SOP_ColorInfo*	getColors() const override;
+	virtual const SOP_TextureInfo*	getTextures() const override;
+
+	virtual const SOP_CustomAttribData*	getCustomAttribute(int32_t customAttribIndex) const override;
+	virtual const SOP_CustomAttribData*	getCustomAttribute(const char* customAttribName) const override;
+
+	virtual bool	hasNormals() const override;
+	virtual bool	hasColors() const override;
+
+	virtual bool	isInside(const Position& pos) override;
+	virtual bool	sendRay(const Position& pos, const Vector& dir,
+							Position& hitPostion, float& hitLength, Vector& hitNormal,
+							float& hitU, float& hitV, int& hitPrimitiveIndex) override;
+
+private:
+
+	CountedVector<Position>				myPositions;
+
+	// myPrimsInfo and myPrimPointIndices point in these
+	CountedVector<SOP_PrimitiveInfo>	myPrimitives;
+	CountedVector<int32_t>				myVertices;
+
+	// the data of myAttribute points in one of the buffers
+	bool					myHasAttribute;
+	std::string				myAttributeName;
+	SOP_CustomAttribData	myAttribute;
+	CountedVector<float>	myAttributeFloats;
+	CountedVector<int32_t>	myAttributeInts;
+};
@@ -0,0 +1,263 @@
+#include "PlanarHull.h"
+#include "PointKernels.h"
+
+#include <algorithm>
+#include <math.h>
+#include <float.h>
+
+namespace
+{
+	inline float
+	distance2(const Position& a, const Position& b)
+	{
+		float dx = a.x - b.x;
+		float dy = a.y - b.y;
+		float dz = a.z - b.z;
+		return dx * dx + dy * dy + dz * dz;
+	}
+
+	inline Vector
+	cross(const Vector& a, const Vector& b)
+	{
+		return Vector(a.y * b.z - a.z * b.y,
+		              a.z * b.x - a.x * b.z,
+		              a.x * b.y - a.y * b.x);
+	}
+
+	// Sine of the angle below which three points are taken as collinear,
+	// about the rounding of the projection to float
+	const double CollinearSine = 1e-6;
+
+	// True when o, a, b make a left turn. The cross product is computed in
+	// double and compared with the lengths of the edges, so the tolerance is
+	// an angle and doesn't drop the vertices of short edges, like those of a
+	// dense circle
+	template<typename P>
+	inline bool
+	turnsLeft(const P& o, const P& a, const P& b)
+	{
+		double ax = static_cast<double>(a.u) - o.u;
+		double ay = static_cast<double>(a.v) - o.v;
+		double bx = static_cast<double>(b.u) - o.u;
+		double by = static_cast<double>(b.v) - o.v;
+
+		double turn = ax * by - ay * bx;
+
+		return turn > 0.0 && turn * turn > CollinearSine * CollinearSine * (ax * ax + ay * ay) * (bx * bx + by * by);
+	}
+}
+
+bool
+PlanarHull::setPlane(const Position* points, int32_t numPoints, const int32_t* extremes,
+						HullPlane plane)
+{
+	if (numPoints < 3)
+		return false;
+
+	// the two extreme points furthest apart, the extremes are spread over
+	// the whole cloud and checking them doesn't read the points again
+	const int32_t numExtremes = PointKernels::NumExtremeDirections * 2;
+
+	int32_t i0 = extremes[0];
+	int32_t i1 = i0;
+	float best = -1.0f;
+
+	for (int32_t a = 0; a < numExtremes; a++)
+	{
+		for (int32_t b = a + 1; b < numExtremes; b++)
+		{
+			float d = distance2(points[extremes[a]], points[extremes[b]]);
+			if (d > best)
+			{
+				best = d;
+				i0 = extremes[a];
+				i1 = extremes[b];
+			}
+		}
+	}
+
+	myExtent = sqrtf(best);
+
+	if (myExtent <= FLT_MIN)
+		return false;
+
+	if (plane == HullPlane::Auto)
+	{
+		// the third point is the extreme point furthest from the line through
+		// the first two
+		Vector dir(points[i1].x - points[i0].x, points[i1].y - points[i0].y, points[i1].z - points[i0].z);
+		dir.normalize();
+
+		best = -1.0f;
+
+		for (int32_t k = 0; k < numExtremes; k++)
+		{
+			const Position& p = points[extremes[k]];
+
+			Vector w(p.x - points[i0].x, p.y - points[i0].y, p.z - points[i0].z);
+			Vector c = cross(dir, w);
+			float d = c.dot(c);
+
+			if (d > best)
+			{
+				best = d;
+				myNormal = c;
+			}
+		}
+
+		if (myNormal.normalize() <= FLT_MIN)
+			return false;
+
+		myD = myNormal.dot(Vector(points[i0].x, points[i0].y, points[i0].z));
+	}
+	else
+	{
+		myNormal = Vector(plane == HullPlane::YZ ? 1.0f : 0.0f,
+		                  plane == HullPlane::ZX ? 1.0f : 0.0f,
+		                  plane == HullPlane::XY ? 1.0f : 0.0f);
+
+		Position center = PointKernels::centroid(points, numPoints);
+		myD = myNormal.dot(Vector(center.x, center.y, center.z));
+	}
+
+	// any vector not parallel to the normal gives the first axis of the basis
+	Vector seed = fabsf(myNormal.x) < 0.9f ? Vector(1.0f, 0.0f, 0.0f) : Vector(0.0f, 1.0f, 0.0f);
+
+	myAxisU = cross(seed, myNormal);
+	myAxisU.normalize();
+	myAxisV = cross(myNormal, myAxisU);
+
+	return true;
+}
+
+bool
+PlanarHull::isCoplanar(const Position* points, int32_t numPoints, const int32_t* extremes,
+						float epsilon) const
+{
+	float plane[4] = { myNormal.x, myNormal.y, myNormal.z, myD };
+	float tolerance = epsilon * myExtent;
+
+	// a 3D cloud has extremes off any plane, which settles it without a scan
+	for (int32_t k = 0; k < PointKernels::NumExtremeDirections * 2; k++)
+	{
+		if (PointKernels::maxPlaneDistance(points + extremes[k], 1, plane) > tolerance)
+			return false;
+	}
+
+	return PointKernels::maxPlaneDistance(points, numPoints, plane, tolerance) <= tolerance;
+}
+
+Position
+PlanarHull::project(const Position& p) const
+{
+	float d = myNormal.dot(Vector(p.x, p.y, p.z)) - myD;
+
+	return Position(p.x - myNormal.x * d, p.y - myNormal.y * d, p.z - myNormal.z * d);
+}
+
+void
+PlanarHull::build(const Position* points, int32_t numPoints, CountedVector<int32_t>& hull)
+{
+	hull.clear();
+
+	myProjected.resize(numPoints);
+
+	for (int32_t i = 0; i < numPoints; i++)
+	{
+		Vector p(points[i].x, points[i].y, points[i].z);
+
+		myProjected[i].u = p.dot(myAxisU);
+		myProjected[i].v = p.dot(myAxisV);
+		myProjected[i].index = i;
+	}
+
+	std::sort(myProjected.begin(), myProjected.end(), [](const Point2& a, const Point2& b)
+	{
+		if (a.u != b.u)
+			return a.u < b.u;
+		if (a.v != b.v)
+			return a.v < b.v;
+		return a.index < b.index;
+	});
+
+	if (numPoints < 3)
+		return;
+
+	// lower chain left to right, then upper chain right to left. Points on
+	// an edge, within float rounding of the projection, are dropped so the
+	// hull has no collinear vertices
+	myChain.resize(numPoints * 2);
+	int32_t k = 0;
+
+	for (int32_t i = 0; i < numPoints; i++)
+	{
+		while (k >= 2 && !turnsLeft(myProjected[myChain[k - 2]], myProjected[myChain[k - 1]], myProjected[i]))
+			k--;
+		myChain[k++] = i;
+	}
+
+	for (int32_t i = numPoints - 2, lower = k + 1; i >= 0; i--)
+	{
+		while (k >= lower && !turnsLeft(myProjected[myChain[k - 2]], myProjected[myChain[k - 1]], myProjected[i]))
+			k--;
+		myChain[k++] = i;
+	}
+
+	// the last point is the first one again
+	k--;
+
+	if (k < 3)
+		return;
+
+	hull.resize(k);
+
+	for (int32_t i = 0; i < k; i++)
+	{
+		hull[i] = myProjected[myChain[i]].index;
+	}
+}
+
+void
+PlanarHull::buildEdgePlanes(const Position* hull, int32_t numHull, const Position& center,
+						CountedVector<float>& planes) const
+{
+	planes.clear();
+
+	if (numHull < 3)
+		return;
+
+	for (int32_t i = 0; i < numHull; i++)
+	{
+		const Position& a = hull[i];
+		const Position& b = hull[(i + 1) % numHull];
+
+		Vector n = cross(Vector(b.x - a.x, b.y - a.y, b.z - a.z), myNormal);
+		float len = n.length();
+
+		if (len <= FLT_MIN)
+			continue;
+
+		n *= 1.0f / len;
+
+		float d = n.x * (a.x - center.x) + n.y * (a.y - center.y) + n.z * (a.z - center.z);
+
+		// orient with the center, whatever the winding of the outline
+		if (d < 0.0f)
+		{
+			n *= -1.0f;
+			d = -d;
+		}
+
+		planes.push_back(n.x);
+		planes.push_back(n.y);
+		planes.push_back(n.z);
+		planes.push_back(d);
+	}
+}
+
+void
+PlanarHull::releaseMemory()
+{
+	freeBuffer(myProjected);
+	freeBuffer(myChain);
+}
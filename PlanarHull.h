@@ -0,0 +1,78 @@
+#pragma once
+
+#include "CPlusPlus_Common.h"
+#include "CountingAllocator.h"
+#include <stdint.h>
+#include <vector>
+
+// Which plane the points are projected on by the 2D engine
+enum class HullPlane : int32_t
+{
+	Auto = 0,
+	XY,
+	YZ,
+	ZX,
+};
+
+// 2D convex hull of points lying on a plane, with Andrew's monotone chain
+// in O(n log n). It doesn't suffer from the numerical trouble quickhull has
+// with coplanar input, and is faster on it.
+class PlanarHull
+{
+public:
+
+	// Sets up the plane for 'plane'. 'extremes' are the points of
+	// PointKernels::findExtremePoints(). With HullPlane::Auto the plane goes
+	// through three of them spread as far apart as possible, otherwise it is
+	// the axis plane through the centroid of the points. Returns false when
+	// the points are all on a line (or a single point).
+	bool		setPlane(const Position* points, int32_t numPoints, const int32_t* extremes,
+						HullPlane plane);
+
+	// Returns true if every point is closer to the plane than 'epsilon' times
+	// the size of the point cloud. The extremes are tested first, and the
+	// scan of the points stops at the first one off the plane.
+	bool		isCoplanar(const Position* points, int32_t numPoints, const int32_t* extremes,
+						float epsilon) const;
+
+	// Computes the hull of the points projected on the plane. 'hull' receives
+	// the indices of the hull points, counter-clockwise around the normal.
+	void		build(const Position* points, int32_t numPoints, CountedVector<int32_t>& hull);
+
+	// Projects a point on the plane
+	Position	project(const Position& p) const;
+
+	const Vector&	getNormal() const { return myNormal; }
+
+	// Fills 'planes' with one (nx, ny, nz, d) plane per edge of the closed
+	// outline 'hull', perpendicular to the plane and facing out of the
+	// outline, in the layout PointKernels uses for the planes of a 3D hull:
+	// relative to 'center', a point inside the outline.
+	void		buildEdgePlanes(const Position* hull, int32_t numHull, const Position& center,
+							CountedVector<float>& planes) const;
+
+	// Frees the scratch of build(), it grows back on the next one
+	void		releaseMemory();
+
+private:
+
+	struct Point2
+	{
+		float		u;
+		float		v;
+		int32_t		index;
+	};
+
+	// plane is n.p = d, with an orthonormal (u, v) basis in it
+	Vector		myNormal;
+	float		myD = 0.0f;
+	Vector		myAxisU;
+	Vector		myAxisV;
+
+	// distance between the two points the plane was fitted on, used as the
+	// size of the point cloud for the coplanarity tolerance
+	float		myExtent = 0.0f;
+
+	CountedVector<Point2>	myProjected;
+	CountedVector<int32_t>	myChain;
+};
@@ -0,0 +1,903 @@
+#include "PointKernels.h"
+
+#include <algorithm>
+#include <limits>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+
+#ifdef POINTKERNELS_SSE2
+	#include <emmintrin.h>
+#endif
+
+namespace
+{
+	const uint64_t Prime1 = 0x9E3779B185EBCA87ULL;
+	const uint64_t Prime2 = 0xC2B2AE3D27D4EB4FULL;
+	const uint64_t Prime3 = 0x165667B19E3779F9ULL;
+
+	inline uint64_t
+	rotl(uint64_t x, int r)
+	{
+		return (x << r) | (x >> (64 - r));
+	}
+
+	inline uint64_t
+	mixLane(uint64_t acc, uint64_t lane)
+	{
+		acc += lane * Prime2;
+		acc = rotl(acc, 31);
+		return acc * Prime1;
+	}
+
+	inline uint64_t
+	load64(const unsigned char* p)
+	{
+		uint64_t v;
+		memcpy(&v, p, sizeof(v));
+		return v;
+	}
+
+	const float ExtremeDirections[PointKernels::NumExtremeDirections][3] =
+	{
+		{ 1.0f,  0.0f,  0.0f },
+		{ 0.0f,  1.0f,  0.0f },
+		{ 0.0f,  0.0f,  1.0f },
+		{ 1.0f,  1.0f,  0.0f },
+		{ 1.0f, -1.0f,  0.0f },
+		{ 1.0f,  0.0f,  1.0f },
+		{ 1.0f,  0.0f, -1.0f },
+		{ 0.0f,  1.0f,  1.0f },
+		{ 0.0f,  1.0f, -1.0f },
+		{ 1.0f,  1.0f,  1.0f },
+		{ 1.0f,  1.0f, -1.0f },
+		{ 1.0f, -1.0f,  1.0f },
+		{ 1.0f, -1.0f, -1.0f },
+	};
+
+	template<typename Real>
+	void
+	findPointsOutsideScalar(const Position* points, int32_t begin, int32_t end,
+						const Real* planes, int32_t numPlanes,
+						const Position& center, Real innerRadius2, Real margin,
+						CountedVector<int32_t>& outside)
+	{
+		for (int32_t i = begin; i < end; i++)
+		{
+			const Position& p = points[i];
+
+			Real dx = static_cast<Real>(p.x) - center.x;
+			Real dy = static_cast<Real>(p.y) - center.y;
+			Real dz = static_cast<Real>(p.z) - center.z;
+
+			if (dx * dx + dy * dy + dz * dz < innerRadius2)
+				continue;
+
+			for (int32_t j = 0; j < numPlanes; j++)
+			{
+				const Real* plane = planes + j * 4;
+
+				if (plane[0] * dx + plane[1] * dy + plane[2] * dz > plane[3] - margin)
+				{
+					outside.push_back(i);
+					break;
+				}
+			}
+		}
+	}
+
+	// Adds point 'index' as a candidate of plane 'plane' at 'distance'
+	inline void
+	addCandidate(int32_t index, int32_t plane, float distance,
+				int32_t* furthest, float* distances, CountedVector<int32_t>& outside)
+	{
+		outside.push_back(index);
+
+		if (distance > distances[plane])
+		{
+			distances[plane] = distance;
+			furthest[plane] = index;
+		}
+	}
+
+	template<typename Real>
+	void
+	furthestOutsideScalar(const Position* points, int32_t begin, int32_t end,
+						const Real* planes, int32_t numPlanes,
+						const Position& center, float tolerance,
+						int32_t* furthest, float* distances,
+						CountedVector<int32_t>& outside)
+	{
+		for (int32_t i = begin; i < end; i++)
+		{
+			const Position& p = points[i];
+
+			Real dx = static_cast<Real>(p.x) - center.x;
+			Real dy = static_cast<Real>(p.y) - center.y;
+			Real dz = static_cast<Real>(p.z) - center.z;
+
+			Real maxDist = tolerance;
+			int32_t maxPlane = -1;
+
+			for (int32_t j = 0; j < numPlanes; j++)
+			{
+				const Real* plane = planes + j * 4;
+				Real dist = plane[0] * dx + plane[1] * dy + plane[2] * dz - plane[3];
+
+				if (dist > maxDist)
+				{
+					maxDist = dist;
+					maxPlane = j;
+				}
+			}
+
+			if (maxPlane >= 0)
+				addCandidate(i, maxPlane, static_cast<float>(maxDist), furthest, distances, outside);
+		}
+	}
+
+	void
+	findExtremePointsScalar(const Position* points, int32_t begin, int32_t end,
+						float* maxValues, int32_t* maxIndices,
+						float* minValues, int32_t* minIndices)
+	{
+		for (int32_t i = begin; i < end; i++)
+		{
+			const Position& p = points[i];
+
+			for (int32_t j = 0; j < PointKernels::NumExtremeDirections; j++)
+			{
+				const float* dir = ExtremeDirections[j];
+				float d = dir[0] * p.x + dir[1] * p.y + dir[2] * p.z;
+
+				if (d > maxValues[j])
+				{
+					maxValues[j] = d;
+					maxIndices[j] = i;
+				}
+
+				if (d < minValues[j])
+				{
+					minValues[j] = d;
+					minIndices[j] = i;
+				}
+			}
+		}
+	}
+
+#ifdef POINTKERNELS_SSE2
+
+	// Loads 4 packed Positions (12 floats) and transposes them to x, y and z lanes
+	inline void
+	loadPoints4(const Position* p, __m128& xs, __m128& ys, __m128& zs)
+	{
+		const float* f = reinterpret_cast<const float*>(p);
+
+		__m128 m0 = _mm_loadu_ps(f);		// x0 y0 z0 x1
+		__m128 m1 = _mm_loadu_ps(f + 4);	// y1 z1 x2 y2
+		__m128 m2 = _mm_loadu_ps(f + 8);	// z2 x3 y3 z3
+
+		__m128 x23 = _mm_shuffle_ps(m1, m2, _MM_SHUFFLE(1, 1, 2, 2));
+		xs = _mm_shuffle_ps(m0, x23, _MM_SHUFFLE(2, 0, 3, 0));
+
+		__m128 y01 = _mm_shuffle_ps(m0, m1, _MM_SHUFFLE(0, 0, 1, 1));
+		__m128 y23 = _mm_shuffle_ps(m1, m2, _MM_SHUFFLE(2, 2, 3, 3));
+		ys = _mm_shuffle_ps(y01, y23, _MM_SHUFFLE(2, 0, 2, 0));
+
+		__m128 z01 = _mm_shuffle_ps(m0, m1, _MM_SHUFFLE(1, 1, 2, 2));
+		zs = _mm_shuffle_ps(z01, m2, _MM_SHUFFLE(3, 0, 2, 0));
+	}
+
+	inline __m128
+	select(__m128 mask, __m128 a, __m128 b)
+	{
+		return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+	}
+
+	inline __m128i
+	select(__m128i mask, __m128i a, __m128i b)
+	{
+		return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+	}
+
+#endif
+
+	template<typename Index, typename Real>
+	float
+	buildPlanesOf(const Position* points, const Index* indices,
+				size_t numTriangles, const Position& center,
+				CountedVector<Real>& planes)
+	{
+		planes.clear();
+		planes.reserve(numTriangles * 4);
+
+		Real innerRadius = std::numeric_limits<Real>::max();
+
+		for (size_t i = 0; i < numTriangles; i++)
+		{
+			const Position& a = points[indices[i * 3]];
+			const Position& b = points[indices[i * 3 + 1]];
+			const Position& c = points[indices[i * 3 + 2]];
+
+			Real abx = static_cast<Real>(b.x) - a.x, aby = static_cast<Real>(b.y) - a.y, abz = static_cast<Real>(b.z) - a.z;
+			Real acx = static_cast<Real>(c.x) - a.x, acy = static_cast<Real>(c.y) - a.y, acz = static_cast<Real>(c.z) - a.z;
+
+			Real nx = aby * acz - abz * acy;
+			Real ny = abz * acx - abx * acz;
+			Real nz = abx * acy - aby * acx;
+
+			Real len = sqrt(nx * nx + ny * ny + nz * nz);
+
+			if (len <= std::numeric_limits<Real>::min())
+				continue;
+
+			nx /= len;
+			ny /= len;
+			nz /= len;
+
+			// the offset from the center is also the distance of the center
+			// to the plane, the winding of the triangles doesn't matter
+			Real d = nx * (static_cast<Real>(a.x) - center.x) +
+			         ny * (static_cast<Real>(a.y) - center.y) +
+			         nz * (static_cast<Real>(a.z) - center.z);
+
+			if (d < 0)
+			{
+				nx = -nx;
+				ny = -ny;
+				nz = -nz;
+				d = -d;
+			}
+
+			if (d < innerRadius)
+				innerRadius = d;
+
+			planes.push_back(nx);
+			planes.push_back(ny);
+			planes.push_back(nz);
+			planes.push_back(d);
+		}
+
+		return planes.empty() ? 0.0f : static_cast<float>(innerRadius);
+	}
+
+	template<typename T, int32_t NumComponents>
+	void
+	gatherFixed(const T* values, const int32_t* indices, int32_t count, T* out)
+	{
+		for (int32_t i = 0; i < count; i++)
+		{
+			const T* value = values + static_cast<size_t>(indices[i]) * NumComponents;
+
+			for (int32_t c = 0; c < NumComponents; c++)
+			{
+				out[c] = value[c];
+			}
+
+			out += NumComponents;
+		}
+	}
+
+	template<typename T>
+	void
+	gatherValues(const T* values, int32_t numComponents, const int32_t* indices,
+				int32_t count, T* out)
+	{
+		// the usual sizes get a loop with a fixed size copy the compiler
+		// unrolls, one call per value costs more than the copy itself
+		switch (numComponents)
+		{
+			case 1:
+				gatherFixed<T, 1>(values, indices, count, out);
+				break;
+			case 2:
+				gatherFixed<T, 2>(values, indices, count, out);
+				break;
+			case 3:
+				gatherFixed<T, 3>(values, indices, count, out);
+				break;
+			case 4:
+				gatherFixed<T, 4>(values, indices, count, out);
+				break;
+			default:
+				for (int32_t i = 0; i < count; i++)
+				{
+					memcpy(out + static_cast<size_t>(i) * numComponents,
+					       values + static_cast<size_t>(indices[i]) * numComponents,
+					       numComponents * sizeof(T));
+				}
+				break;
+		}
+	}
+}
+
+uint64_t
+PointKernels::hashPositions(const Position* points, int32_t numPoints)
+{
+	return hashBytes(points, static_cast<size_t>(numPoints) * sizeof(Position));
+}
+
+uint64_t
+PointKernels::hashBytes(const void* bytes, size_t size)
+{
+	const unsigned char* data = static_cast<const unsigned char*>(bytes);
+
+	// four independent lanes over 32 byte stripes, the lanes don't depend on
+	// each other so the loop runs at memory speed instead of multiply latency
+	uint64_t acc0 = Prime1 + Prime2;
+	uint64_t acc1 = Prime2;
+	uint64_t acc2 = 0;
+	uint64_t acc3 = 0 - Prime1;
+
+	size_t offset = 0;
+
+	for (; offset + 32 <= size; offset += 32)
+	{
+		acc0 = mixLane(acc0, load64(data + offset));
+		acc1 = mixLane(acc1, load64(data + offset + 8));
+		acc2 = mixLane(acc2, load64(data + offset + 16));
+		acc3 = mixLane(acc3, load64(data + offset + 24));
+	}
+
+	uint64_t h = rotl(acc0, 1) + rotl(acc1, 7) + rotl(acc2, 12) + rotl(acc3, 18);
+	h += size;
+
+	for (; offset + 8 <= size; offset += 8)
+	{
+		h ^= mixLane(0, load64(data + offset));
+		h = rotl(h, 27) * Prime1 + Prime3;
+	}
+
+	for (; offset < size; offset++)
+	{
+		h ^= data[offset] * Prime3;
+		h = rotl(h, 11) * Prime1;
+	}
+
+	// final avalanche so that nearby inputs don't give nearby hashes
+	h ^= h >> 33;
+	h *= Prime2;
+	h ^= h >> 29;
+	h *= Prime3;
+	h ^= h >> 32;
+
+	return h;
+}
+
+void
+PointKernels::toDouble(const Position* points, int32_t numPoints, double* out)
+{
+	const float* in = reinterpret_cast<const float*>(points);
+	int32_t numFloats = numPoints * 3;
+	int32_t i = 0;
+
+#ifdef POINTKERNELS_SSE2
+	// the layout is the same on both sides, the coordinates are widened in
+	// a flat stream without caring which point they belong to
+	for (; i + 4 <= numFloats; i += 4)
+	{
+		__m128 f = _mm_loadu_ps(in + i);
+
+		_mm_storeu_pd(out + i, _mm_cvtps_pd(f));
+		_mm_storeu_pd(out + i + 2, _mm_cvtps_pd(_mm_movehl_ps(f, f)));
+	}
+#endif
+
+	for (; i < numFloats; i++)
+	{
+		out[i] = in[i];
+	}
+}
+
+Position
+PointKernels::centroid(const Position* points, int32_t numPoints)
+{
+	// accumulate in double, float sums drift on large inputs
+	double x = 0.0;
+	double y = 0.0;
+	double z = 0.0;
+
+	for (int32_t i = 0; i < numPoints; i++)
+	{
+		x += points[i].x;
+		y += points[i].y;
+		z += points[i].z;
+	}
+
+	double inv = numPoints > 0 ? 1.0 / numPoints : 0.0;
+
+	return Position(static_cast<float>(x * inv),
+	                static_cast<float>(y * inv),
+	                static_cast<float>(z * inv));
+}
+
+float
+PointKernels::buildPlanes(const Position* points, const size_t* indices,
+						size_t numTriangles, const Position& center,
+						CountedVector<float>& planes)
+{
+	return buildPlanesOf(points, indices, numTriangles, center, planes);
+}
+
+float
+PointKernels::buildPlanes(const Position* points, const int32_t* indices,
+						size_t numTriangles, const Position& center,
+						CountedVector<float>& planes)
+{
+	return buildPlanesOf(points, indices, numTriangles, center, planes);
+}
+
+float
+PointKernels::buildPlanes(const Position* points, const size_t* indices,
+						size_t numTriangles, const Position& center,
+						CountedVector<double>& planes)
+{
+	return buildPlanesOf(points, indices, numTriangles, center, planes);
+}
+
+void
+PointKernels::findPointsOutside(const Position* points, int32_t numPoints,
+						const float* planes, int32_t numPlanes,
+						const Position& center, float innerRadius, float margin,
+						CountedVector<int32_t>& outside)
+{
+	float skipRadius = std::max(innerRadius - margin, 0.0f);
+	float skipRadius2 = skipRadius * skipRadius;
+	int32_t i = 0;
+
+#ifdef POINTKERNELS_SSE2
+	__m128 cx = _mm_set1_ps(center.x);
+	__m128 cy = _mm_set1_ps(center.y);
+	__m128 cz = _mm_set1_ps(center.z);
+	__m128 r2 = _mm_set1_ps(skipRadius2);
+	__m128 marginV = _mm_set1_ps(margin);
+
+	for (; i + 4 <= numPoints; i += 4)
+	{
+		__m128 xs, ys, zs;
+		loadPoints4(points + i, xs, ys, zs);
+
+		__m128 dx = _mm_sub_ps(xs, cx);
+		__m128 dy = _mm_sub_ps(ys, cy);
+		__m128 dz = _mm_sub_ps(zs, cz);
+		__m128 d2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+
+		// lanes outside of the inner ball need the plane test
+		int pending = _mm_movemask_ps(_mm_cmpge_ps(d2, r2));
+
+		if (!pending)
+			continue;
+
+		__m128 out = _mm_setzero_ps();
+
+		for (int32_t j = 0; j < numPlanes; j++)
+		{
+			const float* plane = planes + j * 4;
+
+			__m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_load1_ps(plane), dx),
+			                                   _mm_mul_ps(_mm_load1_ps(plane + 1), dy)),
+			                        _mm_mul_ps(_mm_load1_ps(plane + 2), dz));
+
+			out = _mm_or_ps(out, _mm_cmpgt_ps(dot, _mm_sub_ps(_mm_load1_ps(plane + 3), marginV)));
+
+			// stop as soon as every lane we care about is known to be outside
+			if ((_mm_movemask_ps(out) & pending) == pending)
+				break;
+		}
+
+		int outMask = _mm_movemask_ps(out) & pending;
+
+		for (int lane = 0; lane < 4; lane++)
+		{
+			if (outMask & (1 << lane))
+				outside.push_back(i + lane);
+		}
+	}
+#endif
+
+	findPointsOutsideScalar(points, i, numPoints, planes, numPlanes,
+	                        center, skipRadius2, margin, outside);
+}
+
+void
+PointKernels::findPointsOutside(const Position* points, int32_t numPoints,
+						const double* planes, int32_t numPlanes,
+						const Position& center, float innerRadius, float margin,
+						CountedVector<int32_t>& outside)
+{
+	double skipRadius = std::max(static_cast<double>(innerRadius) - margin, 0.0);
+	double skipRadius2 = skipRadius * skipRadius;
+	int32_t i = 0;
+
+#ifdef POINTKERNELS_SSE2
+	__m128d cx = _mm_set1_pd(center.x);
+	__m128d cy = _mm_set1_pd(center.y);
+	__m128d cz = _mm_set1_pd(center.z);
+	__m128d r2 = _mm_set1_pd(skipRadius2);
+	__m128d marginV = _mm_set1_pd(margin);
+
+	// two points at a time, that's all the double lanes there are
+	for (; i + 2 <= numPoints; i += 2)
+	{
+		const Position& p0 = points[i];
+		const Position& p1 = points[i + 1];
+
+		__m128d dx = _mm_sub_pd(_mm_set_pd(p1.x, p0.x), cx);
+		__m128d dy = _mm_sub_pd(_mm_set_pd(p1.y, p0.y), cy);
+		__m128d dz = _mm_sub_pd(_mm_set_pd(p1.z, p0.z), cz);
+		__m128d d2 = _mm_add_pd(_mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy)), _mm_mul_pd(dz, dz));
+
+		int pending = _mm_movemask_pd(_mm_cmpge_pd(d2, r2));
+
+		if (!pending)
+			continue;
+
+		__m128d out = _mm_setzero_pd();
+
+		for (int32_t j = 0; j < numPlanes; j++)
+		{
+			const double* plane = planes + j * 4;
+
+			__m128d dot = _mm_add_pd(_mm_add_pd(_mm_mul_pd(_mm_load1_pd(plane), dx),
+			                                    _mm_mul_pd(_mm_load1_pd(plane + 1), dy)),
+			                         _mm_mul_pd(_mm_load1_pd(plane + 2), dz));
+
+			out = _mm_or_pd(out, _mm_cmpgt_pd(dot, _mm_sub_pd(_mm_load1_pd(plane + 3), marginV)));
+
+			if ((_mm_movemask_pd(out) & pending) == pending)
+				break;
+		}
+
+		int outMask = _mm_movemask_pd(out) & pending;
+
+		if (outMask & 1)
+			outside.push_back(i);
+
+		if (outMask & 2)
+			outside.push_back(i + 1);
+	}
+#endif
+
+	findPointsOutsideScalar(points, i, numPoints, planes, numPlanes,
+	                        center, skipRadius2, static_cast<double>(margin), outside);
+}
+
+float
+PointKernels::furthestOutside(const Position* points, int32_t numPoints,
+						const float* planes, int32_t numPlanes,
+						const Position& center, float tolerance,
+						int32_t* furthest, float* distances,
+						CountedVector<int32_t>& outside)
+{
+	for (int32_t j = 0; j < numPlanes; j++)
+	{
+		furthest[j] = -1;
+		distances[j] = 0.0f;
+	}
+
+	int32_t i = 0;
+
+#ifdef POINTKERNELS_SSE2
+	__m128 cx = _mm_set1_ps(center.x);
+	__m128 cy = _mm_set1_ps(center.y);
+	__m128 cz = _mm_set1_ps(center.z);
+
+	for (; i + 4 <= numPoints; i += 4)
+	{
+		__m128 xs, ys, zs;
+		loadPoints4(points + i, xs, ys, zs);
+
+		xs = _mm_sub_ps(xs, cx);
+		ys = _mm_sub_ps(ys, cy);
+		zs = _mm_sub_ps(zs, cz);
+
+		// every lane keeps the plane it is furthest in front of
+		__m128 maxV = _mm_set1_ps(tolerance);
+		__m128i maxI = _mm_set1_epi32(-1);
+
+		for (int32_t j = 0; j < numPlanes; j++)
+		{
+			const float* plane = planes + j * 4;
+
+			__m128 dist = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_load1_ps(plane), xs),
+			                                               _mm_mul_ps(_mm_load1_ps(plane + 1), ys)),
+			                                    _mm_mul_ps(_mm_load1_ps(plane + 2), zs)),
+			                         _mm_load1_ps(plane + 3));
+
+			__m128 isMax = _mm_cmpgt_ps(dist, maxV);
+			maxV = select(isMax, dist, maxV);
+			maxI = select(_mm_castps_si128(isMax), _mm_set1_epi32(j), maxI);
+		}
+
+		int outMask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(maxI, _mm_set1_epi32(-1))));
+
+		if (!outMask)
+			continue;
+
+		float dists[4];
+		int32_t planeIndices[4];
+		_mm_storeu_ps(dists, maxV);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(planeIndices), maxI);
+
+		for (int lane = 0; lane < 4; lane++)
+		{
+			if (outMask & (1 << lane))
+				addCandidate(i + lane, planeIndices[lane], dists[lane], furthest, distances, outside);
+		}
+	}
+#endif
+
+	furthestOutsideScalar(points, i, numPoints, planes, numPlanes, center, tolerance,
+	                      furthest, distances, outside);
+
+	float maxDist = 0.0f;
+
+	for (int32_t j = 0; j < numPlanes; j++)
+	{
+		maxDist = std::max(maxDist, distances[j]);
+	}
+
+	return maxDist;
+}
+
+float
+PointKernels::furthestOutside(const Position* points, int32_t numPoints,
+						const double* planes, int32_t numPlanes,
+						const Position& center, float tolerance,
+						int32_t* furthest, float* distances,
+						CountedVector<int32_t>& outside)
+{
+	for (int32_t j = 0; j < numPlanes; j++)
+	{
+		furthest[j] = -1;
+		distances[j] = 0.0f;
+	}
+
+	furthestOutsideScalar(points, 0, numPoints, planes, numPlanes, center, tolerance,
+	                      furthest, distances, outside);
+
+	float maxDist = 0.0f;
+
+	for (int32_t j = 0; j < numPlanes; j++)
+	{
+		maxDist = std::max(maxDist, distances[j]);
+	}
+
+	return maxDist;
+}
+
+float
+PointKernels::maxPlaneDistance(const Position* points, int32_t numPoints,
+						const float* plane, float limit)
+{
+	float maxDist = 0.0f;
+	int32_t i = 0;
+
+#ifdef POINTKERNELS_SSE2
+	__m128 nx = _mm_set1_ps(plane[0]);
+	__m128 ny = _mm_set1_ps(plane[1]);
+	__m128 nz = _mm_set1_ps(plane[2]);
+	__m128 d = _mm_set1_ps(plane[3]);
+	__m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+	__m128 limitV = _mm_set1_ps(limit);
+	__m128 maxV = _mm_setzero_ps();
+
+	for (; i + 4 <= numPoints; i += 4)
+	{
+		__m128 xs, ys, zs;
+		loadPoints4(points + i, xs, ys, zs);
+
+		__m128 dist = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, xs), _mm_mul_ps(ny, ys)),
+		                                    _mm_mul_ps(nz, zs)), d);
+
+		maxV = _mm_max_ps(maxV, _mm_and_ps(dist, absMask));
+
+		if (_mm_movemask_ps(_mm_cmpgt_ps(maxV, limitV)))
+			break;
+	}
+
+	float lanes[4];
+	_mm_storeu_ps(lanes, maxV);
+
+	maxDist = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+
+	if (maxDist > limit)
+		return maxDist;
+#endif
+
+	for (; i < numPoints; i++)
+	{
+		const Position& p = points[i];
+		float dist = fabsf(plane[0] * p.x + plane[1] * p.y + plane[2] * p.z - plane[3]);
+
+		if (dist > maxDist)
+		{
+			maxDist = dist;
+
+			if (maxDist > limit)
+				break;
+		}
+	}
+
+	return maxDist;
+}
+
+void
+PointKernels::findExtremePoints(const Position* points, int32_t numPoints,
+						int32_t* indices)
+{
+	float maxValues[NumExtremeDirections];
+	float minValues[NumExtremeDirections];
+	int32_t maxIndices[NumExtremeDirections];
+	int32_t minIndices[NumExtremeDirections];
+
+	for (int32_t j = 0; j < NumExtremeDirections; j++)
+	{
+		maxValues[j] = -FLT_MAX;
+		minValues[j] = FLT_MAX;
+		maxIndices[j] = 0;
+		minIndices[j] = 0;
+	}
+
+	int32_t i = 0;
+
+#ifdef POINTKERNELS_SSE2
+	if (numPoints >= 4)
+	{
+		// every lane keeps its own running min/max, they are reduced at the end
+		__m128 maxV[NumExtremeDirections];
+		__m128 minV[NumExtremeDirections];
+		__m128i maxI[NumExtremeDirections];
+		__m128i minI[NumExtremeDirections];
+
+		for (int32_t j = 0; j < NumExtremeDirections; j++)
+		{
+			maxV[j] = _mm_set1_ps(-FLT_MAX);
+			minV[j] = _mm_set1_ps(FLT_MAX);
+			maxI[j] = _mm_setzero_si128();
+			minI[j] = _mm_setzero_si128();
+		}
+
+		__m128i laneIndex = _mm_set_epi32(3, 2, 1, 0);
+		const __m128i four = _mm_set1_epi32(4);
+
+		for (; i + 4 <= numPoints; i += 4)
+		{
+			__m128 xs, ys, zs;
+			loadPoints4(points + i, xs, ys, zs);
+
+			for (int32_t j = 0; j < NumExtremeDirections; j++)
+			{
+				const float* dir = ExtremeDirections[j];
+
+				__m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(dir[0]), xs),
+				                                 _mm_mul_ps(_mm_set1_ps(dir[1]), ys)),
+				                      _mm_mul_ps(_mm_set1_ps(dir[2]), zs));
+
+				__m128 isMax = _mm_cmpgt_ps(d, maxV[j]);
+				maxV[j] = select(isMax, d, maxV[j]);
+				maxI[j] = select(_mm_castps_si128(isMax), laneIndex, maxI[j]);
+
+				__m128 isMin = _mm_cmplt_ps(d, minV[j]);
+				minV[j] = select(isMin, d, minV[j]);
+				minI[j] = select(_mm_castps_si128(isMin), laneIndex, minI[j]);
+			}
+
+			laneIndex = _mm_add_epi32(laneIndex, four);
+		}
+
+		for (int32_t j = 0; j < NumExtremeDirections; j++)
+		{
+			float mv[4], nv[4];
+			int32_t mi[4], ni[4];
+
+			_mm_storeu_ps(mv, maxV[j]);
+			_mm_storeu_ps(nv, minV[j]);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(mi), maxI[j]);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(ni), minI[j]);
+
+			for (int lane = 0; lane < 4; lane++)
+			{
+				if (mv[lane] > maxValues[j] || (mv[lane] == maxValues[j] && mi[lane] < maxIndices[j]))
+				{
+					maxValues[j] = mv[lane];
+					maxIndices[j] = mi[lane];
+				}
+
+				if (nv[lane] < minValues[j] || (nv[lane] == minValues[j] && ni[lane] < minIndices[j]))
+				{
+					minValues[j] = nv[lane];
+					minIndices[j] = ni[lane];
+				}
+			}
+		}
+	}
+#endif
+
+	findExtremePointsScalar(points, i, numPoints, maxValues, maxIndices, minValues, minIndices);
+
+	for (int32_t j = 0; j < NumExtremeDirections; j++)
+	{
+		indices[j * 2] = maxIndices[j];
+		indices[j * 2 + 1] = minIndices[j];
+	}
+}
+
+void
+PointKernels::gather(const float* values, int32_t numComponents,
+					const int32_t* indices, int32_t count, float* out)
+{
+	gatherValues(values, numComponents, indices, count, out);
+}
+
+void
+PointKernels::gather(const int32_t* values, int32_t numComponents,
+					const int32_t* indices, int32_t count, int32_t* out)
+{
+	gatherValues(values, numComponents, indices, count, out);
+}
+
+void
+PointKernels::planeDepths(const Position* points, int32_t numPoints,
+						const float* planes, int32_t numPlanes,
+						const Position& center, float* depths)
+{
+	if (numPlanes == 0)
+	{
+		std::fill(depths, depths + numPoints, 0.0f);
+		return;
+	}
+
+	int32_t i = 0;
+
+#ifdef POINTKERNELS_SSE2
+	__m128 cx = _mm_set1_ps(center.x);
+	__m128 cy = _mm_set1_ps(center.y);
+	__m128 cz = _mm_set1_ps(center.z);
+
+	for (; i + 4 <= numPoints; i += 4)
+	{
+		__m128 xs, ys, zs;
+		loadPoints4(points + i, xs, ys, zs);
+
+		xs = _mm_sub_ps(xs, cx);
+		ys = _mm_sub_ps(ys, cy);
+		zs = _mm_sub_ps(zs, cz);
+
+		__m128 minV = _mm_set1_ps(FLT_MAX);
+
+		for (int32_t j = 0; j < numPlanes; j++)
+		{
+			const float* plane = planes + j * 4;
+
+			__m128 depth = _mm_sub_ps(_mm_load1_ps(plane + 3),
+			                          _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_load1_ps(plane), xs),
+			                                                _mm_mul_ps(_mm_load1_ps(plane + 1), ys)),
+			                                     _mm_mul_ps(_mm_load1_ps(plane + 2), zs)));
+
+			minV = _mm_min_ps(minV, depth);
+		}
+
+		_mm_storeu_ps(depths + i, minV);
+	}
+#endif
+
+	for (; i < numPoints; i++)
+	{
+		const Position& p = points[i];
+
+		float dx = p.x - center.x;
+		float dy = p.y - center.y;
+		float dz = p.z - center.z;
+
+		float minDepth = FLT_MAX;
+
+		for (int32_t j = 0; j < numPlanes; j++)
+		{
+			const float* plane = planes + j * 4;
+			minDepth = std::min(minDepth, plane[3] - (plane[0] * dx + plane[1] * dy + plane[2] * dz));
+		}
+
+		depths[i] = minDepth;
+	}
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "CPlusPlus_Common.h"
+#include "CountingAllocator.h"
+#include <float.h>
+#include <stdint.h>
+#include <vector>
+
+// SSE2 is always there on x64, other targets (Apple silicon) use the scalar loops
+#if defined(_M_X64) || defined(__SSE2__)
+	#define POINTKERNELS_SSE2 1
+#endif
+
+// Tight loops over the packed Position array of the input SOP.
+// They don't know anything about the node and can be used from any thread.
+namespace PointKernels
+{
+	// Number of fixed directions used by findExtremePoints(): the 3 axes,
+	// the 6 face diagonals and the 4 cube diagonals.
+	const int32_t	NumExtremeDirections = 13;
+
+	// Returns a 64 bit fingerprint of the point positions, used to detect
+	// that the input geometry did not change between two cooks.
+	uint64_t	hashPositions(const Position* points, int32_t numPoints);
+
+	// Same hash over any block of memory.
+	uint64_t	hashBytes(const void* data, size_t size);
+
+	// Widens 'numPoints' points to 3 * numPoints packed doubles in 'out'.
+	void		toDouble(const Position* points, int32_t numPoints, double* out);
+
+	// Computes the centroid of 'numPoints' points.
+	Position	centroid(const Position* points, int32_t numPoints);
+
+	// Fills 'planes' with one (nx, ny, nz, d) plane per triangle of a closed
+	// convex mesh, relative to 'center': n.(p - center) = d on the plane, with
+	// n pointing away from 'center'. Relative planes keep their precision far
+	// from the origin. Degenerate triangles are skipped. Returns the radius of
+	// the largest ball centered on 'center' that fits in the mesh.
+	float		buildPlanes(const Position* points, const size_t* indices,
+							size_t numTriangles, const Position& center,
+							CountedVector<float>& planes);
+	float		buildPlanes(const Position* points, const int32_t* indices,
+							size_t numTriangles, const Position& center,
+							CountedVector<float>& planes);
+	float		buildPlanes(const Position* points, const size_t* indices,
+							size_t numTriangles, const Position& center,
+							CountedVector<double>& planes);
+
+	// Appends to 'outside' the index of every point that lies in front of at
+	// least one of the planes of buildPlanes(), or closer to it than 'margin'.
+	// Points closer than 'innerRadius' - 'margin' to 'center' are known to be
+	// inside and are skipped without testing the planes.
+	void		findPointsOutside(const Position* points, int32_t numPoints,
+							const float* planes, int32_t numPlanes,
+							const Position& center, float innerRadius, float margin,
+							CountedVector<int32_t>& outside);
+	void		findPointsOutside(const Position* points, int32_t numPoints,
+							const double* planes, int32_t numPlanes,
+							const Position& center, float innerRadius, float margin,
+							CountedVector<int32_t>& outside);
+
+	// For every point further than 'tolerance' in front of at least one of the
+	// planes of buildPlanes(), appends its index to 'outside' and makes it a
+	// candidate of the plane it is furthest in front of. 'furthest' and
+	// 'distances' hold one entry per plane and receive the candidate furthest
+	// from each plane, or -1 and 0 when a plane has none. Returns the largest
+	// distance of a point outside the planes.
+	float		furthestOutside(const Position* points, int32_t numPoints,
+							const float* planes, int32_t numPlanes,
+							const Position& center, float tolerance,
+							int32_t* furthest, float* distances,
+							CountedVector<int32_t>& outside);
+	float		furthestOutside(const Position* points, int32_t numPoints,
+							const double* planes, int32_t numPlanes,
+							const Position& center, float tolerance,
+							int32_t* furthest, float* distances,
+							CountedVector<int32_t>& outside);
+
+	// Returns the largest distance between a point and the plane
+	// (nx, ny, nz, d), on either side of it. The scan stops at the first
+	// point further than 'limit' and returns its distance.
+	float		maxPlaneDistance(const Position* points, int32_t numPoints,
+							const float* plane, float limit = FLT_MAX);
+
+	// Finds the points with the largest and smallest projection on each of the
+	// NumExtremeDirections fixed directions. 'indices' must hold
+	// 2 * NumExtremeDirections entries: the max of direction i is written to
+	// indices[i * 2] and the min to indices[i * 2 + 1]. On ties the lowest
+	// point index wins.
+	void		findExtremePoints(const Position* points, int32_t numPoints,
+							int32_t* indices);
+
+	// Writes the depth of every point inside the planes, which are relative
+	// to 'center': the distance to the closest of them, negative for a point
+	// in front of one. With the planes of a convex hull it is the distance to
+	// the hull surface, positive inside. Every depth is 0 when there are no
+	// planes.
+	void		planeDepths(const Position* points, int32_t numPoints,
+							const float* planes, int32_t numPlanes,
+							const Position& center, float* depths);
+
+	// Copies the value of element indices[i] of 'values' to element i of
+	// 'out', for the 'count' indices. A value is 'numComponents' packed
+	// components, e.g. 3 floats for a Vector.
+	void		gather(const float* values, int32_t numComponents,
+							const int32_t* indices, int32_t count, float* out);
+	void		gather(const int32_t* values, int32_t numComponents,
+							const int32_t* indices, int32_t count, int32_t* out);
+}
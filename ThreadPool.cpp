@@ -0,0 +1,130 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+void
+ThreadPool::runTasks(Job& job)
+{
+	for (;;)
+	{
+		int32_t i = job.next.fetch_add(1);
+
+		if (i >= job.numTasks)
+			break;
+
+		job.function(job.task, i);
+
+		std::lock_guard<std::mutex> lock(job.mutex);
+		if (++job.completed == job.numTasks)
+			job.finished.notify_one();
+	}
+}
+
+ThreadPool::ThreadPool(int32_t numWorkers) : myStopping(false)
+{
+	for (int32_t i = 0; i < numWorkers; i++)
+	{
+		myWorkers.emplace_back(&ThreadPool::workerLoop, this);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(myMutex);
+		myStopping = true;
+	}
+
+	myWakeUp.notify_all();
+
+	for (std::thread& worker : myWorkers)
+	{
+		worker.join();
+	}
+}
+
+int32_t
+ThreadPool::getNumWorkers() const
+{
+	return static_cast<int32_t>(myWorkers.size());
+}
+
+void
+ThreadPool::run(int32_t numTasks, int32_t maxThreads, TaskFunction function, const void* task)
+{
+	if (numTasks <= 0)
+		return;
+
+	int32_t numHelpers = std::min(std::min(numTasks, maxThreads) - 1, getNumWorkers());
+
+	if (numHelpers <= 0)
+	{
+		for (int32_t i = 0; i < numTasks; i++)
+		{
+			function(task, i);
+		}
+		return;
+	}
+
+	Job job;
+	job.function = function;
+	job.task = task;
+	job.numTasks = numTasks;
+	job.next = 0;
+	job.completed = 0;
+	job.running = 0;
+
+	{
+		std::lock_guard<std::mutex> lock(myMutex);
+
+		for (int32_t i = 0; i < numHelpers; i++)
+		{
+			myQueue.push_back(&job);
+		}
+	}
+
+	myWakeUp.notify_all();
+
+	runTasks(job);
+
+	// helpers no worker has taken yet would find nothing left, take them back
+	{
+		std::lock_guard<std::mutex> lock(myMutex);
+		myQueue.erase(std::remove(myQueue.begin(), myQueue.end(), &job), myQueue.end());
+	}
+
+	// then wait for the tasks, and for the helpers still reading the job
+	std::unique_lock<std::mutex> lock(job.mutex);
+	job.finished.wait(lock, [&job]() { return job.completed == job.numTasks && job.running == 0; });
+}
+
+void
+ThreadPool::workerLoop()
+{
+	for (;;)
+	{
+		Job* job;
+
+		{
+			std::unique_lock<std::mutex> lock(myMutex);
+			myWakeUp.wait(lock, [this]() { return myStopping || !myQueue.empty(); });
+
+			if (myStopping && myQueue.empty())
+				return;
+
+			job = myQueue.back();
+			myQueue.pop_back();
+
+			// counted before the queue is unlocked, so that a caller taking
+			// its helpers back either finds this one queued or running
+			std::lock_guard<std::mutex> jobLock(job->mutex);
+			job->running++;
+		}
+
+		runTasks(*job);
+
+		std::lock_guard<std::mutex> jobLock(job->mutex);
+		if (--job->running == 0)
+			job->finished.notify_one();
+	}
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A fixed set of worker threads that run the tasks of parallelFor().
+// The calling thread takes tasks too, so parallelFor() can be called from a
+// task without deadlocking even when every worker is busy.
+// Once the pool has run a first call, parallelFor() doesn't allocate.
+class ThreadPool
+{
+public:
+
+	explicit ThreadPool(int32_t numWorkers);
+
+	~ThreadPool();
+
+	// Runs task(i) for every i in [0, numTasks) and returns once they are all
+	// done. At most 'maxThreads' threads, the caller included, work on it.
+	template<typename Task>
+	void
+	parallelFor(int32_t numTasks, int32_t maxThreads, const Task& task)
+	{
+		// the task is called through a plain function pointer, a
+		// std::function of a capturing lambda would allocate every call
+		run(numTasks, maxThreads, &callTask<Task>, &task);
+	}
+
+	int32_t		getNumWorkers() const;
+
+private:
+
+	typedef void	(*TaskFunction)(const void* task, int32_t i);
+
+	// State shared by the threads working on one parallelFor() call. It
+	// lives on the stack of the caller, which waits for every helper to be
+	// done with it before returning.
+	struct Job
+	{
+		TaskFunction			function;
+		const void*				task;
+		int32_t					numTasks;
+		std::atomic<int32_t>	next;
+
+		std::mutex				mutex;
+		std::condition_variable	finished;
+		int32_t					completed;
+
+		// helpers taken off the queue that haven't returned yet
+		int32_t					running;
+	};
+
+	template<typename Task>
+	static void
+	callTask(const void* task, int32_t i)
+	{
+		(*static_cast<const Task*>(task))(i);
+	}
+
+	void		run(int32_t numTasks, int32_t maxThreads, TaskFunction function, const void* task);
+
+	static void	runTasks(Job& job);
+
+	void		workerLoop();
+
+	std::vector<std::thread>	myWorkers;
+
+	std::mutex					myMutex;
+	std::condition_variable		myWakeUp;
+
+	// one entry per helper a call asks for, in any order. It keeps its
+	// capacity, so queueing doesn't allocate once it has grown.
+	std::vector<Job*>			myQueue;
+	bool						myStopping;
+};
@@ -0,0 +1,310 @@
+#include "BenchRunner.h"
+#include "MemoryCounter.h"
+#include "SOP_CPlusPlusBase.h"
+
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+#include <stdlib.h>
+
+extern "C"
+{
+	SOP_CPlusPlusBase*	CreateSOPInstance(const OP_NodeInfo* info);
+	void				DestroySOPInstance(SOP_CPlusPlusBase* instance);
+}
+
+namespace
+{
+	// Nearest rank percentile of sorted values
+	double
+	percentile(const std::vector<double>& sorted, double percent)
+	{
+		int32_t count = static_cast<int32_t>(sorted.size());
+		int32_t rank = static_cast<int32_t>(percent / 100.0 * count + 0.999999);
+
+		return sorted[std::min(std::max(rank, 1), count) - 1];
+	}
+
+	// Median of 'field' over the results
+	template<typename T>
+	T
+	median(const std::vector<BenchResult>& results, T BenchResult::*field)
+	{
+		std::vector<T> values;
+
+		for (const BenchResult& result : results)
+		{
+			values.push_back(result.*field);
+		}
+
+		std::sort(values.begin(), values.end());
+		return values[values.size() / 2];
+	}
+
+	// Returns the Info CHOP channel called 'name', 0 if there is none
+	float
+	infoChannel(SOP_CPlusPlusBase* node, const char* name)
+	{
+		for (int32_t i = 0; i < node->getNumInfoCHOPChans(nullptr); i++)
+		{
+			MockString chanName;
+			OP_InfoCHOPChan chan;
+			chan.name = &chanName;
+			chan.value = 0.0f;
+
+			node->getInfoCHOPChan(i, &chan, nullptr);
+
+			if (chanName.value == name)
+				return chan.value;
+		}
+
+		return 0.0f;
+	}
+
+	bool
+	setParameter(MockParameterManager& manager, MockInputs& inputs, const std::string& name,
+				const std::string& value, std::string& error)
+	{
+		if (manager.set(inputs, name, value))
+			return true;
+
+		error = "unknown parameter '" + name + "'";
+		return false;
+	}
+}
+
+bool
+BenchRunner::run(const BenchConfig& config, BenchResult& result, std::string& error)
+{
+	SOP_CPlusPlusBase* node = CreateSOPInstance(nullptr);
+
+	MockParameterManager manager;
+	node->setupParameters(&manager, nullptr);
+
+	MockSOPInput input;
+	MockInputs inputs;
+	inputs.sop = &input;
+	manager.applyDefaults(inputs);
+
+	// the dataset's parameters, then the ones of the run
+	std::istringstream datasetPars(config.dataset->pars);
+	std::string pair;
+	bool valid = true;
+
+	while (valid && datasetPars >> pair)
+	{
+		size_t equal = pair.find('=');
+		valid = setParameter(manager, inputs, pair.substr(0, equal), pair.substr(equal + 1), error);
+	}
+
+	for (size_t i = 0; valid && i < config.pars.size(); i++)
+	{
+		valid = setParameter(manager, inputs, config.pars[i].first, config.pars[i].second, error);
+	}
+
+	if (!valid)
+	{
+		DestroySOPInstance(node);
+		return false;
+	}
+
+	typedef std::chrono::steady_clock Clock;
+
+	std::mt19937 rng(config.seed + 1);
+	std::uniform_real_distribution<float> step(-0.001f, 0.001f);
+
+	size_t baseBytes = 0;
+	size_t totalAllocations = 0;
+
+	// the outputs are reused like the host does, so that the allocations
+	// counted during the cooks are the ones of the node
+	MockSOPOutput sopOutput;
+	MockVBOOutput vboOutput;
+
+	std::vector<double> latencies;
+	double stageTotals[3] = { 0.0, 0.0, 0.0 };
+	const char* stageNames[3] = { "input_fetch_ms", "hull_build_ms", "output_emit_ms" };
+
+	for (int32_t cook = 0; cook < config.numWarmup + config.numCooks; cook++)
+	{
+		// changing the input is not timed
+		if (cook == 0 || (config.changing && config.dataset->animated))
+		{
+			Datasets::generate(*config.dataset, config.numPoints, config.seed, cook, input);
+
+			if (cook == 0)
+			{
+				baseBytes = MemoryCounter::getCurrentBytes();
+				MemoryCounter::resetPeak();
+			}
+		}
+		else if (config.changing)
+		{
+			for (Position& p : input.points)
+			{
+				p.x += step(rng);
+				p.y += step(rng);
+				p.z += step(rng);
+			}
+
+			input.finalize();
+		}
+
+		inputs.time.absFrame = cook;
+		inputs.time.frame = static_cast<double>(cook);
+
+		Clock::time_point start;
+		Clock::time_point end;
+
+		size_t allocations = MemoryCounter::getAllocations();
+
+		if (config.vbo)
+		{
+			vboOutput.clear();
+
+			start = Clock::now();
+			node->executeVBO(&vboOutput, &inputs, nullptr);
+			end = Clock::now();
+
+			result.hullVertices = static_cast<int32_t>(vboOutput.positions.size());
+			result.hullFaces = static_cast<int32_t>(vboOutput.triangles.size() / 3);
+		}
+		else
+		{
+			sopOutput.clear();
+
+			start = Clock::now();
+			node->execute(&sopOutput, &inputs, nullptr);
+			end = Clock::now();
+
+			result.hullVertices = sopOutput.getNumPoints();
+			result.hullFaces = static_cast<int32_t>(sopOutput.triangles.size() / 3);
+		}
+
+		allocations = MemoryCounter::getAllocations() - allocations;
+
+		if (cook < config.numWarmup)
+			continue;
+
+		latencies.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+		totalAllocations += allocations;
+
+		for (int32_t i = 0; i < 3; i++)
+		{
+			stageTotals[i] += infoChannel(node, stageNames[i]);
+		}
+	}
+
+	result.peakBytes = MemoryCounter::getPeakBytes() - baseBytes;
+
+	if (config.perElementEmit && !config.vbo)
+	{
+		MockSOPOutput perElement;
+		double totalEmitMs = 0.0;
+
+		for (int32_t cook = 0; cook < config.numCooks; cook++)
+		{
+			perElement.clear();
+
+			Clock::time_point start = Clock::now();
+
+			for (const Position& p : sopOutput.points)
+			{
+				perElement.addPoint(p);
+			}
+
+			for (size_t i = 0; i + 2 < sopOutput.triangles.size(); i += 3)
+			{
+				perElement.addTriangle(sopOutput.triangles[i], sopOutput.triangles[i + 1], sopOutput.triangles[i + 2]);
+			}
+
+			totalEmitMs += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		}
+
+		result.perElementEmitMs = totalEmitMs / config.numCooks;
+	}
+
+	DestroySOPInstance(node);
+
+	double totalMs = 0.0;
+
+	for (double ms : latencies)
+	{
+		totalMs += ms;
+	}
+
+	std::sort(latencies.begin(), latencies.end());
+
+	result.meanMs = totalMs / config.numCooks;
+	result.p50Ms = percentile(latencies, 50.0);
+	result.p50MinMs = result.p50Ms;
+	result.p95Ms = percentile(latencies, 95.0);
+	result.p99Ms = percentile(latencies, 99.0);
+	result.maxMs = latencies.back();
+
+	result.fetchMs = stageTotals[0] / config.numCooks;
+	result.buildMs = stageTotals[1] / config.numCooks;
+	result.emitMs = stageTotals[2] / config.numCooks;
+
+	result.allocationsPerCook = static_cast<double>(totalAllocations) / config.numCooks;
+
+	result.pointsPerSecond = result.meanMs > 0.0 ? config.numPoints * 1000.0 / result.meanMs : 0.0;
+
+	return true;
+}
+
+bool
+BenchRunner::repeat(const BenchConfig& config, int32_t numRepetitions, BenchRun& run,
+					std::string& error)
+{
+	std::vector<BenchResult> results(numRepetitions);
+
+	for (BenchResult& result : results)
+	{
+		if (!BenchRunner::run(config, result, error))
+			return false;
+	}
+
+	run.dataset = config.dataset;
+	run.numPoints = config.numPoints;
+	run.numRepetitions = numRepetitions;
+
+	BenchResult& r = run.result;
+	r.hullVertices = median(results, &BenchResult::hullVertices);
+	r.hullFaces = median(results, &BenchResult::hullFaces);
+	r.meanMs = median(results, &BenchResult::meanMs);
+	r.p50Ms = median(results, &BenchResult::p50Ms);
+	r.p95Ms = median(results, &BenchResult::p95Ms);
+	r.p99Ms = median(results, &BenchResult::p99Ms);
+	r.maxMs = median(results, &BenchResult::maxMs);
+	r.fetchMs = median(results, &BenchResult::fetchMs);
+	r.buildMs = median(results, &BenchResult::buildMs);
+	r.emitMs = median(results, &BenchResult::emitMs);
+	r.perElementEmitMs = median(results, &BenchResult::perElementEmitMs);
+	r.pointsPerSecond = median(results, &BenchResult::pointsPerSecond);
+	r.peakBytes = median(results, &BenchResult::peakBytes);
+	r.allocationsPerCook = median(results, &BenchResult::allocationsPerCook);
+
+	r.p50MinMs = r.p50Ms;
+
+	for (const BenchResult& result : results)
+	{
+		r.p50MinMs = std::min(r.p50MinMs, result.p50Ms);
+	}
+
+	return true;
+}
+
+bool
+BenchRunner::isAsync(const BenchConfig& config)
+{
+	bool async = false;
+
+	for (const auto& par : config.pars)
+	{
+		if (par.first == "Async")
+			async = atof(par.second.c_str()) != 0.0;
+	}
+
+	return async;
+}
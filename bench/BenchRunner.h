@@ -0,0 +1,91 @@
+#pragma once
+
+#include "Datasets.h"
+#include <stdint.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+// One benchmark run: a new node cooked over a dataset of one size
+struct BenchConfig
+{
+	const Dataset*	dataset = nullptr;
+	int32_t			numPoints = 100000;
+	int32_t			numCooks = 20;
+
+	// untimed cooks before the timed ones
+	int32_t			numWarmup = 2;
+	uint32_t		seed = 1;
+
+	// cook with executeVBO(), as with Direct to GPU on
+	bool			vbo = false;
+
+	// the input changes every cook: animated datasets advance a frame, the
+	// others move by a small random step. Otherwise the hull cache is hit.
+	bool			changing = true;
+
+	// also time the output of the last cook added one addPoint() and one
+	// addTriangle() call at a time, as the node did before it emitted in
+	// bulk. Only with execute().
+	bool			perElementEmit = false;
+
+	// set after the dataset's own parameters
+	std::vector<std::pair<std::string, std::string>>	pars;
+};
+
+struct BenchResult
+{
+	int32_t		hullVertices = 0;
+	int32_t		hullFaces = 0;
+
+	// cook latency over the timed cooks
+	double		meanMs = 0.0;
+	double		p50Ms = 0.0;
+	double		p95Ms = 0.0;
+	double		p99Ms = 0.0;
+	double		maxMs = 0.0;
+
+	// lowest p50 of the repetitions of a run, the least noisy to compare
+	double		p50MinMs = 0.0;
+
+	// mean of the stage timings of the Info CHOP
+	double		fetchMs = 0.0;
+	double		buildMs = 0.0;
+	double		emitMs = 0.0;
+
+	// the same points and triangles added one call each, with perElementEmit
+	double		perElementEmitMs = 0.0;
+
+	double		pointsPerSecond = 0.0;
+
+	// most memory allocated by the node and quickhull during the cooks, the
+	// input not included
+	size_t		peakBytes = 0;
+
+	// heap allocations made during a timed cook, by the node and quickhull.
+	// With a changing input of a fixed size it is what a steady cook costs.
+	double		allocationsPerCook = 0.0;
+};
+
+// A run repeated on new nodes, with the median of the repetitions
+struct BenchRun
+{
+	const Dataset*	dataset = nullptr;
+	int32_t			numPoints = 0;
+	int32_t			numRepetitions = 0;
+	BenchResult		result;
+};
+
+namespace BenchRunner
+{
+	// Returns false, with the reason in 'error', if a parameter doesn't exist
+	bool		run(const BenchConfig& config, BenchResult& result, std::string& error);
+
+	// Runs 'config' 'numRepetitions' times, every field of the result is the
+	// median of the repetitions except p50MinMs
+	bool		repeat(const BenchConfig& config, int32_t numRepetitions, BenchRun& run,
+					std::string& error);
+
+	// True when the parameters of the run turn Async on
+	bool		isAsync(const BenchConfig& config);
+}
@@ -0,0 +1,462 @@
+// Runs the Convex Hull SOP outside of TouchDesigner, through the same
+// execute()/executeVBO() calls the host makes, and reports how fast it cooks.
+//
+//   ConvexHullBench [options] [Parameter=value ...]
+//
+//   --dataset A,B  datasets to cook (default cube), see --list
+//   --points N,M   numbers of input points (default 100000)
+//   --suite        every dataset at 1k, 10k, 100k, 1M and 10M points
+//   --cooks N      number of timed cooks (default 20, 5 with --suite)
+//   --warmup N     untimed cooks before them (default 2, 1 with --suite)
+//   --seed N       seed of the datasets (default 1)
+//   --vbo          cook with executeVBO(), as with Direct to GPU on
+//   --static       leave the input unchanged between cooks, so the hull cache
+//                  is hit. By default the points move a little every cook.
+//   --repeat N     run everything N times on new nodes and report the
+//                  median (default 1)
+//   --json FILE    also write the results to FILE as JSON
+//   --compare FILE compare the results with a baseline written by --json,
+//                  exit with 2 if any regressed. The baseline must have been
+//                  run in the same mode with the same parameters.
+//   --latency-tolerance [DATASET=]PERCENT
+//   --memory-tolerance [DATASET=]PERCENT
+//                  how much slower or bigger a run may get before it
+//                  regresses, for every dataset or one (default 10 and 5)
+//   --emit         time the output stage on spheres with 10k, 100k and 1M
+//                  hull vertices, against adding the same points and
+//                  triangles one call at a time
+//   --list         list the datasets
+//   --check        check the hulls the node outputs instead, exit with 1 if
+//                  any is wrong
+//
+// Parameter=value sets a parameter of the node by name, a menu by item name:
+//   ConvexHullBench --points 1000000 Threads=4 Precision=Double
+
+#include "BenchRunner.h"
+#include "HullChecks.h"
+#include "RegressionGate.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+namespace
+{
+	struct BenchOptions
+	{
+		BenchConfig					config;
+		std::vector<const Dataset*>	datasets;
+		std::vector<int32_t>		sizes;
+		std::string					jsonPath;
+		std::string					baselinePath;
+		GateTolerances				tolerances;
+		int32_t						numRepetitions = 1;
+
+		bool		suite = false;
+		bool		emit = false;
+		bool		list = false;
+		bool		check = false;
+		bool		cooksSet = false;
+		bool		warmupSet = false;
+	};
+
+	void
+	printUsage()
+	{
+		printf("usage: ConvexHullBench [--dataset A,B] [--points N,M] [--suite] [--cooks N]\n"
+		       "                       [--warmup N] [--seed N] [--vbo] [--static] [--repeat N]\n"
+		       "                       [--json FILE] [--compare FILE]\n"
+		       "                       [--latency-tolerance [DATASET=]PERCENT]\n"
+		       "                       [--memory-tolerance [DATASET=]PERCENT]\n"
+		       "                       [--emit] [--list] [--check] [Parameter=value ...]\n");
+	}
+
+	std::vector<std::string>
+	splitList(const char* list)
+	{
+		std::vector<std::string> items;
+		std::string item;
+
+		for (const char* c = list; ; c++)
+		{
+			if (*c == ',' || *c == '\0')
+			{
+				if (!item.empty())
+					items.push_back(item);
+				item.clear();
+
+				if (*c == '\0')
+					break;
+			}
+			else
+				item += *c;
+		}
+
+		return items;
+	}
+
+	// Reads PERCENT or DATASET=PERCENT into the default or the dataset's tolerance
+	bool
+	parseTolerance(const char* arg, double& percent, std::map<std::string, double>& datasetPercent)
+	{
+		const char* equal = strchr(arg, '=');
+
+		if (!equal)
+		{
+			percent = atof(arg);
+			return true;
+		}
+
+		std::string name(arg, equal);
+
+		if (!Datasets::find(name.c_str()))
+		{
+			fprintf(stderr, "unknown dataset '%s'\n", name.c_str());
+			return false;
+		}
+
+		datasetPercent[name] = atof(equal + 1);
+		return true;
+	}
+
+	bool
+	parseOptions(int argc, char** argv, BenchOptions& options)
+	{
+		BenchConfig& config = options.config;
+
+		for (int i = 1; i < argc; i++)
+		{
+			const char* arg = argv[i];
+			bool hasValue = i + 1 < argc;
+
+			if (strcmp(arg, "--dataset") == 0 && hasValue)
+			{
+				for (const std::string& name : splitList(argv[++i]))
+				{
+					const Dataset* dataset = Datasets::find(name.c_str());
+
+					if (!dataset)
+					{
+						fprintf(stderr, "unknown dataset '%s'\n", name.c_str());
+						return false;
+					}
+
+					options.datasets.push_back(dataset);
+				}
+			}
+			else if (strcmp(arg, "--points") == 0 && hasValue)
+			{
+				for (const std::string& size : splitList(argv[++i]))
+				{
+					options.sizes.push_back(atoi(size.c_str()));
+				}
+			}
+			else if (strcmp(arg, "--cooks") == 0 && hasValue)
+			{
+				config.numCooks = atoi(argv[++i]);
+				options.cooksSet = true;
+			}
+			else if (strcmp(arg, "--warmup") == 0 && hasValue)
+			{
+				config.numWarmup = atoi(argv[++i]);
+				options.warmupSet = true;
+			}
+			else if (strcmp(arg, "--seed") == 0 && hasValue)
+				config.seed = static_cast<uint32_t>(atoi(argv[++i]));
+			else if (strcmp(arg, "--repeat") == 0 && hasValue)
+				options.numRepetitions = atoi(argv[++i]);
+			else if (strcmp(arg, "--json") == 0 && hasValue)
+				options.jsonPath = argv[++i];
+			else if (strcmp(arg, "--compare") == 0 && hasValue)
+				options.baselinePath = argv[++i];
+			else if (strcmp(arg, "--latency-tolerance") == 0 && hasValue)
+			{
+				if (!parseTolerance(argv[++i], options.tolerances.latencyPercent,
+				                    options.tolerances.datasetLatencyPercent))
+					return false;
+			}
+			else if (strcmp(arg, "--memory-tolerance") == 0 && hasValue)
+			{
+				if (!parseTolerance(argv[++i], options.tolerances.memoryPercent,
+				                    options.tolerances.datasetMemoryPercent))
+					return false;
+			}
+			else if (strcmp(arg, "--suite") == 0)
+				options.suite = true;
+			else if (strcmp(arg, "--emit") == 0)
+				options.emit = true;
+			else if (strcmp(arg, "--list") == 0)
+				options.list = true;
+			else if (strcmp(arg, "--check") == 0)
+				options.check = true;
+			else if (strcmp(arg, "--vbo") == 0)
+				config.vbo = true;
+			else if (strcmp(arg, "--static") == 0)
+				config.changing = false;
+			else if (strchr(arg, '=') && arg[0] != '-')
+			{
+				const char* equal = strchr(arg, '=');
+				config.pars.emplace_back(std::string(arg, equal), std::string(equal + 1));
+			}
+			else
+				return false;
+		}
+
+		// the suite covers everything not given explicitly, with fewer cooks
+		// since the large sizes take seconds each
+		if (options.suite)
+		{
+			if (options.datasets.empty())
+			{
+				for (const Dataset& dataset : Datasets::getAll())
+				{
+					options.datasets.push_back(&dataset);
+				}
+			}
+
+			if (options.sizes.empty())
+				options.sizes = { 1000, 10000, 100000, 1000000, 10000000 };
+
+			if (!options.cooksSet)
+				config.numCooks = 5;
+
+			if (!options.warmupSet)
+				config.numWarmup = 1;
+		}
+
+		// the hull is built once and cached, so every cook is an emit. With
+		// Epsilon at 0 every point of the sphere is a hull vertex, and the
+		// normals are left out to time the points and triangles alone.
+		if (options.emit)
+		{
+			if (options.datasets.empty())
+				options.datasets.push_back(Datasets::find("sphere"));
+
+			if (options.sizes.empty())
+				options.sizes = { 10000, 100000, 1000000 };
+
+			config.changing = false;
+			config.perElementEmit = true;
+			config.pars.insert(config.pars.begin(), { { "Epsilon", "0" }, { "Normals", "None" } });
+		}
+
+		if (options.datasets.empty())
+			options.datasets.push_back(Datasets::find("cube"));
+
+		if (options.sizes.empty())
+			options.sizes.push_back(100000);
+
+		for (int32_t size : options.sizes)
+		{
+			if (size <= 0)
+				return false;
+		}
+
+		return config.numCooks > 0 && config.numWarmup >= 0 && options.numRepetitions > 0;
+	}
+
+	// Writes 'value' as a quoted JSON string
+	void
+	writeJsonString(FILE* file, const std::string& value)
+	{
+		fputc('"', file);
+
+		for (char c : value)
+		{
+			if (c == '"' || c == '\\')
+				fprintf(file, "\\%c", c);
+			else if (static_cast<unsigned char>(c) < 0x20)
+				fprintf(file, "\\u%04x", c);
+			else
+				fputc(c, file);
+		}
+
+		fputc('"', file);
+	}
+
+	bool
+	writeJson(const std::string& path, const BenchOptions& options, const std::vector<BenchRun>& runs)
+	{
+		FILE* file = fopen(path.c_str(), "w");
+
+		if (!file)
+			return false;
+
+		const BenchConfig& config = options.config;
+
+		fprintf(file, "{\n");
+		fprintf(file, "  \"benchmark\": \"ConvexHull\",\n");
+		fprintf(file, "  \"mode\": \"%s\",\n", config.vbo ? "executeVBO" : "execute");
+		fprintf(file, "  \"changing\": %s,\n", config.changing ? "true" : "false");
+		fprintf(file, "  \"async\": %s,\n", BenchRunner::isAsync(config) ? "true" : "false");
+		fprintf(file, "  \"cooks\": %d,\n", config.numCooks);
+		fprintf(file, "  \"warmup\": %d,\n", config.numWarmup);
+		fprintf(file, "  \"repetitions\": %d,\n", options.numRepetitions);
+		fprintf(file, "  \"seed\": %u,\n", config.seed);
+		fprintf(file, "  \"parameters\": {");
+
+		for (size_t i = 0; i < config.pars.size(); i++)
+		{
+			fprintf(file, i == 0 ? " " : ", ");
+			writeJsonString(file, config.pars[i].first);
+			fprintf(file, ": ");
+			writeJsonString(file, config.pars[i].second);
+		}
+
+		fprintf(file, " },\n");
+		fprintf(file, "  \"results\": [\n");
+
+		for (size_t i = 0; i < runs.size(); i++)
+		{
+			const BenchResult& r = runs[i].result;
+
+			fprintf(file, "    {\n");
+			fprintf(file, "      \"dataset\": \"%s\",\n", runs[i].dataset->name);
+			fprintf(file, "      \"points\": %d,\n", runs[i].numPoints);
+			fprintf(file, "      \"hull_vertices\": %d,\n", r.hullVertices);
+			fprintf(file, "      \"hull_faces\": %d,\n", r.hullFaces);
+			fprintf(file, "      \"latency_ms\": { \"mean\": %.6f, \"p50\": %.6f, \"p95\": %.6f, \"p99\": %.6f, \"max\": %.6f, \"p50_min\": %.6f },\n",
+			        r.meanMs, r.p50Ms, r.p95Ms, r.p99Ms, r.maxMs, r.p50MinMs);
+			fprintf(file, "      \"stages_ms\": { \"fetch\": %.6f, \"build\": %.6f, \"emit\": %.6f },\n",
+			        r.fetchMs, r.buildMs, r.emitMs);
+
+			if (config.perElementEmit)
+				fprintf(file, "      \"per_element_emit_ms\": %.6f,\n", r.perElementEmitMs);
+
+			fprintf(file, "      \"peak_bytes\": %zu,\n", r.peakBytes);
+			fprintf(file, "      \"allocations_per_cook\": %.1f,\n", r.allocationsPerCook);
+			fprintf(file, "      \"points_per_second\": %.1f\n", r.pointsPerSecond);
+			fprintf(file, "    }%s\n", i + 1 < runs.size() ? "," : "");
+		}
+
+		fprintf(file, "  ]\n");
+		fprintf(file, "}\n");
+
+		return fclose(file) == 0;
+	}
+}
+
+int
+main(int argc, char** argv)
+{
+	BenchOptions options;
+
+	if (!parseOptions(argc, argv, options))
+	{
+		printUsage();
+		return 1;
+	}
+
+	if (options.list)
+	{
+		for (const Dataset& dataset : Datasets::getAll())
+		{
+			printf("%-12s %s\n", dataset.name, dataset.description);
+		}
+
+		return 0;
+	}
+
+	if (options.check)
+		return HullChecks::run() > 0 ? 1 : 0;
+
+	const BenchConfig& defaults = options.config;
+
+	if (!options.baselinePath.empty())
+	{
+		std::string error;
+
+		if (!RegressionGate::checkConfig(options.baselinePath, defaults, error))
+		{
+			fprintf(stderr, "%s\n", error.c_str());
+			return 1;
+		}
+	}
+
+	printf("%d cooks x %d (%s, %s)", defaults.numCooks, options.numRepetitions, defaults.vbo ? "executeVBO" : "execute",
+	       defaults.changing ? "changing input" : "static input");
+
+	for (const auto& par : defaults.pars)
+	{
+		printf(", %s = %s", par.first.c_str(), par.second.c_str());
+	}
+
+	printf("\n\n");
+	if (options.emit)
+	{
+		printf("%-12s %10s %8s %8s %10s %12s %8s\n", "dataset", "points", "hull_pts", "faces", "emit_ms",
+		       "per_elem_ms", "speedup");
+	}
+	else
+	{
+		printf("%-12s %10s %8s %8s %10s %10s %10s %10s %10s %10s %10s %8s %10s\n", "dataset", "points", "hull_pts",
+		       "faces", "mean_ms", "p50_ms", "p95_ms", "p99_ms", "build_ms", "emit_ms", "peak_mb", "allocs",
+		       "Mpoints/s");
+	}
+
+	std::vector<BenchRun> runs;
+
+	for (const Dataset* dataset : options.datasets)
+	{
+		for (int32_t size : options.sizes)
+		{
+			BenchConfig config = defaults;
+			config.dataset = dataset;
+			config.numPoints = size;
+
+			BenchRun run;
+			std::string error;
+
+			if (!BenchRunner::repeat(config, options.numRepetitions, run, error))
+			{
+				fprintf(stderr, "%s\n", error.c_str());
+				return 1;
+			}
+
+			const BenchResult& r = run.result;
+
+			if (options.emit)
+			{
+				printf("%-12s %10d %8d %8d %10.3f %12.3f %8.1f\n", dataset->name, size, r.hullVertices,
+				       r.hullFaces, r.emitMs, r.perElementEmitMs,
+				       r.emitMs > 0.0 ? r.perElementEmitMs / r.emitMs : 0.0);
+			}
+			else
+			{
+				printf("%-12s %10d %8d %8d %10.3f %10.3f %10.3f %10.3f %10.3f %10.3f %10.2f %8.1f %10.2f\n",
+				       dataset->name, size, r.hullVertices, r.hullFaces, r.meanMs, r.p50Ms, r.p95Ms, r.p99Ms,
+				       r.buildMs, r.emitMs, r.peakBytes / 1048576.0, r.allocationsPerCook,
+				       r.pointsPerSecond / 1.0e6);
+			}
+			fflush(stdout);
+
+			runs.push_back(run);
+		}
+	}
+
+	if (!options.jsonPath.empty() && !writeJson(options.jsonPath, options, runs))
+	{
+		fprintf(stderr, "could not write %s\n", options.jsonPath.c_str());
+		return 1;
+	}
+
+	if (!options.baselinePath.empty())
+	{
+		std::string error;
+		int32_t numRegressions = RegressionGate::compare(options.baselinePath, defaults, runs,
+		                                                 options.tolerances, error);
+
+		if (numRegressions < 0)
+		{
+			fprintf(stderr, "%s\n", error.c_str());
+			return 1;
+		}
+
+		if (numRegressions > 0)
+			return 2;
+	}
+
+	return 0;
+}
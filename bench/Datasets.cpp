@@ -0,0 +1,259 @@
+#include "Datasets.h"
+
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+
+namespace
+{
+	// uniform in the cube from -1 to 1, the hull is a small part of the input
+	void
+	generateCube(std::mt19937& rng, int32_t numPoints, int32_t, MockSOPInput& input)
+	{
+		std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+
+		input.points.resize(numPoints);
+
+		for (Position& p : input.points)
+		{
+			p = Position(uniform(rng), uniform(rng), uniform(rng));
+		}
+	}
+
+	// normal distribution around the origin, a few far points make the hull
+	void
+	generateGaussian(std::mt19937& rng, int32_t numPoints, int32_t, MockSOPInput& input)
+	{
+		std::normal_distribution<float> normal(0.0f, 0.5f);
+
+		input.points.resize(numPoints);
+
+		for (Position& p : input.points)
+		{
+			p = Position(normal(rng), normal(rng), normal(rng));
+		}
+	}
+
+	// the gaussian blob 1000 units away from the origin, where a float only
+	// has about a ten thousandth of a unit of precision left. quickhull
+	// scales Epsilon with the coordinates, the dataset lowers it to match.
+	void
+	generateDistant(std::mt19937& rng, int32_t numPoints, int32_t frame, MockSOPInput& input)
+	{
+		generateGaussian(rng, numPoints, frame, input);
+
+		for (Position& p : input.points)
+		{
+			p = Position(p.x + 1000.0f, p.y + 1000.0f, p.z + 1000.0f);
+		}
+	}
+
+	// on the unit sphere, every point is on the hull
+	void
+	generateSphere(std::mt19937& rng, int32_t numPoints, int32_t, MockSOPInput& input)
+	{
+		std::normal_distribution<float> normal(0.0f, 1.0f);
+
+		input.points.resize(numPoints);
+
+		for (Position& p : input.points)
+		{
+			float length = 0.0f;
+
+			while (length < 1e-6f)
+			{
+				p = Position(normal(rng), normal(rng), normal(rng));
+				length = sqrtf(p.x * p.x + p.y * p.y + p.z * p.z);
+			}
+
+			p.x /= length;
+			p.y /= length;
+			p.z /= length;
+		}
+	}
+
+	// 4 tilted parallel squares, each only 1e-5 thick, so the faces of the
+	// hull are built from nearly coplanar points
+	void
+	generateSlabs(std::mt19937& rng, int32_t numPoints, int32_t, MockSOPInput& input)
+	{
+		const int32_t numSlabs = 4;
+
+		std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+		std::uniform_real_distribution<float> thickness(-0.5e-5f, 0.5e-5f);
+		std::uniform_int_distribution<int32_t> slab(0, numSlabs - 1);
+
+		// unit normal of the slabs and two axes in them
+		const float n[3] = { 0.267261f, 0.534522f, 0.801784f };
+		const float u[3] = { 0.894427f, -0.447214f, 0.0f };
+		const float v[3] = { 0.358569f, 0.717137f, -0.597614f };
+
+		input.points.resize(numPoints);
+
+		for (Position& p : input.points)
+		{
+			float a = uniform(rng);
+			float b = uniform(rng);
+			float h = (slab(rng) - (numSlabs - 1) * 0.5f) * 0.5f + thickness(rng);
+
+			p = Position(a * u[0] + b * v[0] + h * n[0],
+			             a * u[1] + b * v[1] + h * n[1],
+			             a * u[2] + b * v[2] + h * n[2]);
+		}
+	}
+
+	// 1 unique position in 100 on average, each repeated in random order
+	void
+	generateDuplicates(std::mt19937& rng, int32_t numPoints, int32_t, MockSOPInput& input)
+	{
+		int32_t numUnique = std::max(numPoints / 100, 4);
+
+		std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+		std::uniform_int_distribution<int32_t> pick(0, numUnique - 1);
+
+		std::vector<Position> unique(numUnique);
+
+		for (Position& p : unique)
+		{
+			p = Position(uniform(rng), uniform(rng), uniform(rng));
+		}
+
+		input.points.resize(numPoints);
+
+		for (int32_t i = 0; i < numPoints; i++)
+		{
+			// every unique point appears at least once
+			input.points[i] = unique[i < numUnique ? i : pick(rng)];
+		}
+
+		std::shuffle(input.points.begin(), input.points.end(), rng);
+	}
+
+	// clusters of 1000 points, like the pieces of a fracture, with their
+	// index in the int attribute "piece"
+	void
+	generatePieces(std::mt19937& rng, int32_t numPoints, int32_t, MockSOPInput& input)
+	{
+		int32_t numPieces = std::max(numPoints / 1000, 1);
+
+		std::uniform_real_distribution<float> uniform(-10.0f, 10.0f);
+		std::normal_distribution<float> normal(0.0f, 0.3f);
+
+		std::vector<Position> centers(numPieces);
+
+		for (Position& c : centers)
+		{
+			c = Position(uniform(rng), uniform(rng), uniform(rng));
+		}
+
+		std::vector<int32_t> piece(numPoints);
+		input.points.resize(numPoints);
+
+		for (int32_t i = 0; i < numPoints; i++)
+		{
+			piece[i] = static_cast<int32_t>(static_cast<int64_t>(i) * numPieces / numPoints);
+
+			const Position& c = centers[piece[i]];
+			input.points[i] = Position(c.x + normal(rng), c.y + normal(rng), c.z + normal(rng));
+		}
+
+		input.addAttribute("piece", 1, piece);
+	}
+
+	// a gaussian blob that turns around Y and stretches along X over time
+	void
+	generateAnimated(std::mt19937& rng, int32_t numPoints, int32_t frame, MockSOPInput& input)
+	{
+		generateGaussian(rng, numPoints, frame, input);
+
+		float angle = frame * 0.05f;
+		float c = cosf(angle);
+		float s = sinf(angle);
+		float stretch = 1.0f + 0.5f * sinf(frame * 0.1f);
+
+		for (Position& p : input.points)
+		{
+			float x = p.x * stretch;
+
+			p = Position(c * x + s * p.z, p.y, c * p.z - s * x);
+		}
+	}
+
+	// the gaussian blob with a normal, a color, a texture layer and two
+	// custom attributes on every point, for the cost of carrying them
+	void
+	generateAttributes(std::mt19937& rng, int32_t numPoints, int32_t frame, MockSOPInput& input)
+	{
+		generateGaussian(rng, numPoints, frame, input);
+
+		std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+
+		input.normals.resize(numPoints);
+		input.colors.resize(numPoints);
+		input.texCoords.resize(numPoints);
+		input.numTexLayers = 1;
+
+		std::vector<float> scale(numPoints);
+		std::vector<int32_t> id(numPoints);
+
+		for (int32_t i = 0; i < numPoints; i++)
+		{
+			const Position& p = input.points[i];
+
+			input.normals[i] = Vector(p.x, p.y, p.z);
+			input.normals[i].normalize();
+			input.colors[i] = Color(uniform(rng), uniform(rng), uniform(rng), 1.0f);
+			input.texCoords[i] = TexCoord(uniform(rng), uniform(rng), 0.0f);
+
+			scale[i] = uniform(rng);
+			id[i] = i;
+		}
+
+		input.addAttribute("pscale", 1, scale);
+		input.addAttribute("id", 1, id);
+	}
+
+	const std::vector<Dataset> theDatasets =
+	{
+		{ "cube", "uniform in a cube", "", false, generateCube },
+		{ "gaussian", "gaussian blob", "", false, generateGaussian },
+		{ "sphere", "on a sphere, every point on the hull", "", false, generateSphere },
+		{ "slabs", "near coplanar parallel slabs", "", false, generateSlabs },
+		{ "duplicates", "each position repeated about 100 times", "", false, generateDuplicates },
+		{ "distant", "gaussian blob far from the origin", "Precision=Double Epsilon=0.0000001", false, generateDistant },
+		{ "pieces", "clusters of 1000 points split by attribute", "Splitby=Attribute Splitattrib=piece", false, generatePieces },
+		{ "animated", "gaussian blob turning and stretching", "", true, generateAnimated },
+		{ "attributes", "gaussian blob with point attributes", "", false, generateAttributes },
+	};
+}
+
+const std::vector<Dataset>&
+Datasets::getAll()
+{
+	return theDatasets;
+}
+
+const Dataset*
+Datasets::find(const char* name)
+{
+	for (const Dataset& dataset : theDatasets)
+	{
+		if (strcmp(dataset.name, name) == 0)
+			return &dataset;
+	}
+
+	return nullptr;
+}
+
+void
+Datasets::generate(const Dataset& dataset, int32_t numPoints, uint32_t seed,
+				int32_t frame, MockSOPInput& input)
+{
+	// the frame only moves animated datasets, the random numbers are the same
+	// for every frame
+	std::mt19937 rng(seed);
+
+	input.clear();
+	dataset.generate(rng, numPoints, frame, input);
+	input.finalize();
+}
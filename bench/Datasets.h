@@ -0,0 +1,36 @@
+#pragma once
+
+#include "MockHost.h"
+#include <random>
+#include <stdint.h>
+#include <vector>
+
+// Seeded generators of benchmark inputs, each stressing a different case of
+// the hull. The same dataset, size, seed and frame always give the same input.
+
+struct Dataset
+{
+	const char*	name;
+	const char*	description;
+
+	// Parameter=value pairs, separated by spaces, the dataset is cooked with
+	const char*	pars;
+
+	// the points change from frame to frame
+	bool		animated;
+
+	void		(*generate)(std::mt19937& rng, int32_t numPoints, int32_t frame, MockSOPInput& input);
+};
+
+namespace Datasets
+{
+	const std::vector<Dataset>&	getAll();
+
+	// Returns nullptr if there is no dataset called 'name'
+	const Dataset*		find(const char* name);
+
+	// Replaces the content of 'input' with 'numPoints' points of the dataset
+	// at 'frame', and finalizes it
+	void				generate(const Dataset& dataset, int32_t numPoints, uint32_t seed,
+								int32_t frame, MockSOPInput& input);
+}
@@ -0,0 +1,676 @@
+#include "HullChecks.h"
+#include "Datasets.h"
+#include "MockHost.h"
+
+#include <algorithm>
+#include <math.h>
+#include <random>
+#include <sstream>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+// the plugin's entry points, from ConvexHull.cpp
+extern "C"
+{
+	SOP_CPlusPlusBase*	CreateSOPInstance(const OP_NodeInfo* info);
+	void				DestroySOPInstance(SOP_CPlusPlusBase* instance);
+}
+
+namespace
+{
+	typedef std::vector<std::pair<std::string, std::string>> Pars;
+
+	// A new node with its parameters at their defaults, then 'pars'
+	class CheckNode
+	{
+	public:
+
+		CheckNode(const Pars& pars)
+		{
+			myNode = CreateSOPInstance(nullptr);
+			myNode->setupParameters(&myManager, nullptr);
+
+			myInputs.sop = nullptr;
+			myManager.applyDefaults(myInputs);
+
+			for (const auto& par : pars)
+			{
+				if (!myManager.set(myInputs, par.first, par.second))
+					fprintf(stderr, "unknown parameter '%s'\n", par.first.c_str());
+			}
+		}
+
+		~CheckNode()
+		{
+			DestroySOPInstance(myNode);
+		}
+
+		// Cooks the next frame with execute() over 'input'
+		void
+		cook(const MockSOPInput& input, MockSOPOutput& output)
+		{
+			myInputs.sop = &input;
+			myInputs.time.absFrame++;
+			myInputs.time.frame = static_cast<double>(myInputs.time.absFrame);
+
+			output.clear();
+			myNode->execute(&output, &myInputs, nullptr);
+		}
+
+		// The Info CHOP channel called 'name', 0 if there is none
+		float
+		channel(const char* name)
+		{
+			for (int32_t i = 0; i < myNode->getNumInfoCHOPChans(nullptr); i++)
+			{
+				MockString chanName;
+				OP_InfoCHOPChan chan;
+				chan.name = &chanName;
+				chan.value = 0.0f;
+
+				myNode->getInfoCHOPChan(i, &chan, nullptr);
+
+				if (chanName.value == name)
+					return chan.value;
+			}
+
+			return 0.0f;
+		}
+
+		// The warning of the last cook, empty when there is none
+		std::string
+		warning()
+		{
+			MockString warning;
+			myNode->getWarningString(&warning, nullptr);
+			return warning.value;
+		}
+
+	private:
+
+		SOP_CPlusPlusBase*		myNode;
+		MockParameterManager	myManager;
+		MockInputs				myInputs;
+	};
+
+	// The parameters a dataset is cooked with, then 'pars'
+	Pars
+	datasetPars(const Dataset& dataset, const Pars& pars)
+	{
+		Pars all;
+		std::istringstream stream(dataset.pars);
+		std::string pair;
+
+		while (stream >> pair)
+		{
+			size_t equal = pair.find('=');
+			all.emplace_back(pair.substr(0, equal), pair.substr(equal + 1));
+		}
+
+		all.insert(all.end(), pars.begin(), pars.end());
+		return all;
+	}
+
+	std::string
+	describe(const Dataset& dataset, int32_t numPoints, const Pars& pars)
+	{
+		std::string name = std::string(dataset.name) + " " + std::to_string(numPoints);
+
+		for (const auto& par : pars)
+		{
+			name += " " + par.first + "=" + par.second;
+		}
+
+		return name;
+	}
+
+	// True when both outputs have the same points and triangles, in the same
+	// order
+	bool
+	sameOutput(const MockSOPOutput& a, const MockSOPOutput& b)
+	{
+		if (a.points.size() != b.points.size() || a.triangles != b.triangles)
+			return false;
+
+		for (size_t i = 0; i < a.points.size(); i++)
+		{
+			if (a.points[i].x != b.points[i].x || a.points[i].y != b.points[i].y || a.points[i].z != b.points[i].z)
+				return false;
+		}
+
+		return true;
+	}
+
+	int32_t	theNumFailures = 0;
+
+	void
+	report(bool passed, const std::string& name, const std::string& detail)
+	{
+		printf("%-4s %-48s %s\n", passed ? "ok" : "FAIL", name.c_str(), detail.c_str());
+		fflush(stdout);
+
+		if (!passed)
+			theNumFailures++;
+	}
+
+	// Largest distance of an input point outside a convex polygon in the
+	// z = 0 plane, given by its vertices in order. Each point is tested
+	// against the edge of the wedge around the center it falls in.
+	double
+	maxOutsideDistance2D(const std::vector<Position>& points, const std::vector<Position>& polygon)
+	{
+		int32_t n = static_cast<int32_t>(polygon.size());
+
+		if (n < 3)
+			return HUGE_VAL;
+
+		double cx = 0.0;
+		double cy = 0.0;
+
+		for (const Position& p : polygon)
+		{
+			cx += p.x;
+			cy += p.y;
+		}
+
+		cx /= n;
+		cy /= n;
+
+		// the vertices counter-clockwise around the center, whatever the
+		// winding of the outline
+		std::vector<std::pair<double, int32_t>> angles(n);
+
+		for (int32_t i = 0; i < n; i++)
+		{
+			angles[i] = std::make_pair(atan2(polygon[i].y - cy, polygon[i].x - cx), i);
+		}
+
+		std::sort(angles.begin(), angles.end());
+
+		double worst = 0.0;
+
+		for (const Position& p : points)
+		{
+			double angle = atan2(p.y - cy, p.x - cx);
+
+			size_t next = std::upper_bound(angles.begin(), angles.end(), std::make_pair(angle, n)) - angles.begin();
+			size_t prev = next == 0 ? n - 1 : next - 1;
+			next = next % n;
+
+			const Position& a = polygon[angles[prev].second];
+			const Position& b = polygon[angles[next].second];
+
+			double ex = static_cast<double>(b.x) - a.x;
+			double ey = static_cast<double>(b.y) - a.y;
+			double length = sqrt(ex * ex + ey * ey);
+
+			if (length <= 0.0)
+				continue;
+
+			double outside = -(ex * (p.y - a.y) - ey * (p.x - a.x)) / length;
+			worst = std::max(worst, outside);
+		}
+
+		return worst;
+	}
+
+	// Largest distance of an input point outside the output hulls, one per
+	// piece when the input was split. A point is outside a convex hull by at
+	// least its distance to the furthest face plane in front of it, and only
+	// counts as outside if it is outside every piece.
+	double
+	maxOutsideDistance3D(const std::vector<Position>& points, const MockSOPOutput& output)
+	{
+		auto pieceIds = output.intAttributes.find("pieceid");
+		bool split = pieceIds != output.intAttributes.end();
+
+		int32_t numPieces = 1;
+
+		if (split)
+			numPieces = *std::max_element(pieceIds->second.begin(), pieceIds->second.end()) + 1;
+
+		// the center of every piece, the face planes point away from it
+		std::vector<double> centers(numPieces * 4, 0.0);
+
+		for (size_t i = 0; i < output.points.size(); i++)
+		{
+			double* c = &centers[(split ? pieceIds->second[i] : 0) * 4];
+			c[0] += output.points[i].x;
+			c[1] += output.points[i].y;
+			c[2] += output.points[i].z;
+			c[3] += 1.0;
+		}
+
+		std::vector<std::vector<double>> planes(numPieces);
+
+		for (size_t t = 0; t + 2 < output.triangles.size(); t += 3)
+		{
+			const Position& a = output.points[output.triangles[t]];
+			const Position& b = output.points[output.triangles[t + 1]];
+			const Position& c = output.points[output.triangles[t + 2]];
+
+			double ux = static_cast<double>(b.x) - a.x;
+			double uy = static_cast<double>(b.y) - a.y;
+			double uz = static_cast<double>(b.z) - a.z;
+			double vx = static_cast<double>(c.x) - a.x;
+			double vy = static_cast<double>(c.y) - a.y;
+			double vz = static_cast<double>(c.z) - a.z;
+
+			double nx = uy * vz - uz * vy;
+			double ny = uz * vx - ux * vz;
+			double nz = ux * vy - uy * vx;
+			double length = sqrt(nx * nx + ny * ny + nz * nz);
+
+			if (length <= 0.0)
+				continue;
+
+			nx /= length;
+			ny /= length;
+			nz /= length;
+
+			int32_t piece = split ? pieceIds->second[output.triangles[t]] : 0;
+			const double* center = &centers[piece * 4];
+
+			double d = nx * a.x + ny * a.y + nz * a.z;
+
+			if (nx * center[0] + ny * center[1] + nz * center[2] > d * center[3])
+			{
+				nx = -nx;
+				ny = -ny;
+				nz = -nz;
+				d = -d;
+			}
+
+			planes[piece].insert(planes[piece].end(), { nx, ny, nz, d });
+		}
+
+		double worst = 0.0;
+
+		for (const Position& p : points)
+		{
+			double outside = HUGE_VAL;
+
+			for (const std::vector<double>& piecePlanes : planes)
+			{
+				double furthest = -HUGE_VAL;
+
+				for (size_t i = 0; i < piecePlanes.size(); i += 4)
+				{
+					furthest = std::max(furthest, piecePlanes[i] * p.x + piecePlanes[i + 1] * p.y +
+					                              piecePlanes[i + 2] * p.z - piecePlanes[i + 3]);
+				}
+
+				outside = std::min(outside, furthest);
+			}
+
+			worst = std::max(worst, outside);
+		}
+
+		return worst;
+	}
+
+	// Points on the unit circle at random angles, the hull keeps about all
+	// of them and its edges get shorter with every point added
+	void
+	checkDenseCircle(int32_t numPoints)
+	{
+		std::mt19937 rng(7);
+		std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+
+		MockSOPInput input;
+		input.points.resize(numPoints);
+
+		for (Position& p : input.points)
+		{
+			double angle = uniform(rng) * 3.14159265358979323846;
+			p = Position(static_cast<float>(cos(angle)), static_cast<float>(sin(angle)), 0.0f);
+		}
+
+		input.finalize();
+
+		CheckNode node({ { "Dimension", "2D" }, { "Planaroutput", "Polygon" } });
+		MockSOPOutput output;
+		node.cook(input, output);
+
+		double outside = maxOutsideDistance2D(input.points, output.points);
+
+		char detail[128];
+		snprintf(detail, sizeof(detail), "%d vertices, %g outside", output.getNumPoints(), outside);
+
+		// the points lie on the circle up to float rounding
+		report(outside <= 1e-5, "dense circle " + std::to_string(numPoints), detail);
+	}
+
+	// A time budget that doesn't run out must leave the hull complete: no
+	// input point further outside it than outside the hull built without one
+	void
+	checkUnspentBudget(const char* datasetName, int32_t numPoints, const char* threads)
+	{
+		const Dataset& dataset = *Datasets::find(datasetName);
+
+		MockSOPInput input;
+		Datasets::generate(dataset, numPoints, 1, 0, input);
+
+		Pars pars = { { "Threads", threads } };
+
+		CheckNode node(datasetPars(dataset, pars));
+		MockSOPOutput output;
+		node.cook(input, output);
+
+		pars.emplace_back("Timebudget", "1000000");
+
+		CheckNode budgetNode(datasetPars(dataset, pars));
+		MockSOPOutput budgetOutput;
+		budgetNode.cook(input, budgetOutput);
+
+		double outside = maxOutsideDistance3D(input.points, output);
+		double budgetOutside = maxOutsideDistance3D(input.points, budgetOutput);
+		bool expired = budgetNode.channel("budget_expired") != 0.0f;
+
+		char detail[128];
+		snprintf(detail, sizeof(detail), "%d vertices, %g outside, with the budget %d, %g%s",
+		         output.getNumPoints(), outside, budgetOutput.getNumPoints(), budgetOutside,
+		         expired ? ", expired" : "");
+
+		report(!expired && budgetOutside <= outside + 1e-5, describe(dataset, numPoints, pars), detail);
+	}
+
+	// A time budget that runs out must end the build around the deadline,
+	// with the hull grown so far
+	void
+	checkExpiringBudget(const char* datasetName, int32_t numPoints, const char* threads)
+	{
+		const Dataset& dataset = *Datasets::find(datasetName);
+
+		MockSOPInput input;
+		Datasets::generate(dataset, numPoints, 1, 0, input);
+
+		Pars pars = { { "Threads", threads } };
+
+		CheckNode node(datasetPars(dataset, pars));
+		MockSOPOutput output;
+		node.cook(input, output);
+
+		float buildMs = node.channel("hull_build_ms");
+
+		const float budgetMs = 20.0f;
+		pars.emplace_back("Timebudget", std::to_string(static_cast<int32_t>(budgetMs)));
+
+		CheckNode budgetNode(datasetPars(dataset, pars));
+		MockSOPOutput budgetOutput;
+		budgetNode.cook(input, budgetOutput);
+
+		float budgetBuildMs = budgetNode.channel("hull_build_ms");
+		bool expired = budgetNode.channel("budget_expired") != 0.0f;
+
+		char detail[160];
+		snprintf(detail, sizeof(detail), "%d vertices in %.1f ms, with the budget %d in %.1f ms%s",
+		         output.getNumPoints(), buildMs, budgetOutput.getNumPoints(), budgetBuildMs,
+		         expired ? ", expired" : "");
+
+		// the last round or block can end past the deadline, not by much
+		report(expired && budgetOutput.getNumPoints() >= 4 && budgetBuildMs <= budgetMs * 2.0f + 10.0f,
+		       describe(dataset, numPoints, pars), detail);
+	}
+
+	// The same point indices grouped into other polygons split the input
+	// into other pieces, the cached hull of the first split can't be output
+	void
+	checkSplitPolygons()
+	{
+		std::mt19937 rng(3);
+		std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+
+		MockSOPInput input;
+		input.points.resize(12);
+
+		for (Position& p : input.points)
+		{
+			p = Position(uniform(rng), uniform(rng), uniform(rng));
+		}
+
+		input.addPolygon({ 0, 1, 2, 3 });
+		input.addPolygon({ 4, 5, 6, 7, 8, 9, 10, 11 });
+		input.finalize();
+
+		Pars pars = { { "Splitby", "Connectivity" } };
+
+		CheckNode node(pars);
+		MockSOPOutput output;
+		node.cook(input, output);
+
+		input.clear();
+		input.points.resize(12);
+
+		std::mt19937 same(3);
+
+		for (Position& p : input.points)
+		{
+			p = Position(uniform(same), uniform(same), uniform(same));
+		}
+
+		input.addPolygon({ 0, 1, 2, 3, 4, 5 });
+		input.addPolygon({ 6, 7, 8, 9, 10, 11 });
+		input.finalize();
+
+		node.cook(input, output);
+
+		CheckNode fresh(pars);
+		MockSOPOutput freshOutput;
+		fresh.cook(input, freshOutput);
+
+		char detail[128];
+		snprintf(detail, sizeof(detail), "%d vertices, %d on a new node", output.getNumPoints(),
+		         freshOutput.getNumPoints());
+
+		report(sameOutput(output, freshOutput), "quad and octagon, then two hexagons", detail);
+	}
+
+	// Tag Input Points can only output triangles: a quad becomes two of them,
+	// with a warning, and the triangle next to it goes through as it is
+	void
+	checkTaggedPolygons()
+	{
+		std::mt19937 rng(5);
+		std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+
+		MockSOPInput input;
+		input.points.resize(7);
+
+		for (Position& p : input.points)
+		{
+			p = Position(uniform(rng), uniform(rng), uniform(rng));
+		}
+
+		input.addPolygon({ 0, 1, 2, 3 });
+		input.addPolygon({ 4, 5, 6 });
+		input.finalize();
+
+		Pars pars = { { "Output", "Taginput" } };
+
+		CheckNode node(pars);
+		MockSOPOutput output;
+		node.cook(input, output);
+
+		int32_t numTriangles = static_cast<int32_t>(output.triangles.size() / 3);
+		std::string warning = node.warning();
+
+		char detail[160];
+		snprintf(detail, sizeof(detail), "%d points, %d triangles, %s", output.getNumPoints(), numTriangles,
+		         warning.empty() ? "no warning" : warning.c_str());
+
+		report(output.getNumPoints() == 7 && numTriangles == 3 && !warning.empty(), "quad and triangle tagged",
+		       detail);
+	}
+
+	// A cook that outputs the cached hull must warn like the cook that built
+	// it did
+	void
+	checkCachedWarning()
+	{
+		const Dataset& dataset = *Datasets::find("cube");
+
+		MockSOPInput input;
+		Datasets::generate(dataset, 1000, 1, 0, input);
+
+		CheckNode node({ { "Splitby", "Attribute" }, { "Splitattrib", "missing" } });
+		MockSOPOutput output;
+		node.cook(input, output);
+		std::string built = node.warning();
+
+		node.cook(input, output);
+		std::string cached = node.warning();
+
+		report(!built.empty() && cached == built, "missing split attribute, cooked twice",
+		       cached.empty() ? "no warning on the second cook" : cached.c_str());
+	}
+
+	// A Memory Cap below what the hull keeps can't be met, the memory is
+	// released once to find that out and not after every cook
+	void
+	checkMemoryCapBelowHull()
+	{
+		const Dataset& dataset = *Datasets::find("cube");
+
+		MockSOPInput input;
+		Datasets::generate(dataset, 200000, 1, 0, input);
+
+		CheckNode node({ { "Cache", "0" }, { "Memorycap", "0.001" } });
+		MockSOPOutput output;
+
+		for (int32_t i = 0; i < 5; i++)
+		{
+			node.cook(input, output);
+		}
+
+		int32_t releases = static_cast<int32_t>(node.channel("memory_releases"));
+
+		char detail[128];
+		snprintf(detail, sizeof(detail), "%d releases in 5 cooks, %s", releases,
+		         node.warning().empty() ? "no warning" : "warned");
+
+		report(releases == 1 && !node.warning().empty(), "cube 200000 Memorycap=0.001", detail);
+	}
+
+	// Moves the points of 'input' to the next frame: the next one of an
+	// animated dataset, or by a small random step
+	void
+	moveInput(const Dataset& dataset, int32_t numPoints, MockSOPInput& input)
+	{
+		if (dataset.animated)
+		{
+			Datasets::generate(dataset, numPoints, 1, 1, input);
+			return;
+		}
+
+		std::mt19937 rng(2);
+		std::uniform_real_distribution<float> step(-0.001f, 0.001f);
+
+		for (Position& p : input.points)
+		{
+			p.x += step(rng);
+			p.y += step(rng);
+			p.z += step(rng);
+		}
+
+		input.finalize();
+	}
+
+	// The parallel slices, the prefilter and the warm start, with and without
+	// threads, must give the hull of the serial build: as many vertices and
+	// faces, and no input point further outside it. Each node cooks the
+	// dataset then its next frame, so the warm start is used on the second.
+	void
+	checkBuildPaths(const char* datasetName, int32_t numPoints)
+	{
+		const Dataset& dataset = *Datasets::find(datasetName);
+
+		MockSOPInput input;
+		Datasets::generate(dataset, numPoints, 1, 0, input);
+
+		MockSOPInput moved;
+		Datasets::generate(dataset, numPoints, 1, 0, moved);
+		moveInput(dataset, numPoints, moved);
+
+		CheckNode serial(datasetPars(dataset, { { "Threads", "1" } }));
+		MockSOPOutput serialOutput;
+		serial.cook(moved, serialOutput);
+
+		double serialOutside = maxOutsideDistance3D(moved.points, serialOutput);
+		int32_t serialFaces = static_cast<int32_t>(serialOutput.triangles.size() / 3);
+
+		const Pars paths[] =
+		{
+			{ { "Threads", "4" } },
+			{ { "Threads", "1" }, { "Prefilter", "1" } },
+			{ { "Threads", "4" }, { "Prefilter", "1" } },
+			{ { "Threads", "1" }, { "Warmstart", "1" } },
+			{ { "Threads", "4" }, { "Warmstart", "1" } },
+		};
+
+		for (const Pars& pars : paths)
+		{
+			CheckNode node(datasetPars(dataset, pars));
+			MockSOPOutput output;
+			node.cook(input, output);
+			node.cook(moved, output);
+
+			double outside = maxOutsideDistance3D(moved.points, output);
+			int32_t faces = static_cast<int32_t>(output.triangles.size() / 3);
+
+			char detail[128];
+			snprintf(detail, sizeof(detail), "%d/%d vertices/faces, %g outside, serial %d/%d, %g",
+			         output.getNumPoints(), faces, outside, serialOutput.getNumPoints(), serialFaces,
+			         serialOutside);
+
+			bool passed = output.getNumPoints() == serialOutput.getNumPoints() && faces == serialFaces &&
+			              outside <= serialOutside + 1e-5;
+
+			report(passed, describe(dataset, numPoints, pars), detail);
+		}
+	}
+}
+
+int32_t
+HullChecks::run()
+{
+	theNumFailures = 0;
+
+	for (int32_t numPoints : { 1000, 10000, 100000 })
+	{
+		checkDenseCircle(numPoints);
+	}
+
+	for (const char* threads : { "1", "4" })
+	{
+		checkUnspentBudget("cube", 200000, threads);
+		checkUnspentBudget("gaussian", 200000, threads);
+		checkUnspentBudget("sphere", 2000, threads);
+
+		checkExpiringBudget("sphere", 200000, threads);
+	}
+
+	checkSplitPolygons();
+	checkTaggedPolygons();
+	checkCachedWarning();
+	checkMemoryCapBelowHull();
+
+	// enough points for four slices, fewer where the hull is big or the
+	// pieces are many
+	for (const Dataset& dataset : Datasets::getAll())
+	{
+		int32_t numPoints = 200000;
+
+		if (strcmp(dataset.name, "sphere") == 0)
+			numPoints = 2000;
+		else if (strcmp(dataset.name, "pieces") == 0)
+			numPoints = 20000;
+
+		checkBuildPaths(dataset.name, numPoints);
+	}
+
+	return theNumFailures;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <stdint.h>
+
+// Correctness checks of the hulls the node outputs, run by
+// ConvexHullBench --check and by ctest. Every check prints a line, the
+// failed ones start with FAIL.
+
+namespace HullChecks
+{
+	// Returns the number of failed checks
+	int32_t		run();
+}
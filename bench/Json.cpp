@@ -0,0 +1,272 @@
+#include "Json.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+namespace
+{
+	class JsonParser
+	{
+	public:
+
+		JsonParser(const std::string& text) :
+			myText(text.c_str()),
+			myPos(0)
+		{
+		}
+
+		bool
+		parseDocument(JsonValue& value, std::string& error)
+		{
+			if (!parseValue(value))
+			{
+				error = myError + " at offset " + std::to_string(myPos);
+				return false;
+			}
+
+			skipSpace();
+
+			if (myText[myPos] != '\0')
+			{
+				error = "unexpected text after the value at offset " + std::to_string(myPos);
+				return false;
+			}
+
+			return true;
+		}
+
+	private:
+
+		void
+		skipSpace()
+		{
+			while (myText[myPos] == ' ' || myText[myPos] == '\t' ||
+			       myText[myPos] == '\n' || myText[myPos] == '\r')
+			{
+				myPos++;
+			}
+		}
+
+		bool
+		fail(const char* message)
+		{
+			myError = message;
+			return false;
+		}
+
+		bool
+		match(const char* word)
+		{
+			size_t length = strlen(word);
+
+			if (strncmp(myText + myPos, word, length) != 0)
+				return false;
+
+			myPos += length;
+			return true;
+		}
+
+		bool
+		parseString(std::string& out)
+		{
+			// the opening quote has been checked by the caller
+			myPos++;
+			out.clear();
+
+			while (myText[myPos] != '"')
+			{
+				char c = myText[myPos++];
+
+				if (c == '\0')
+					return fail("unterminated string");
+
+				if (c != '\\')
+				{
+					out += c;
+					continue;
+				}
+
+				char escape = myText[myPos++];
+
+				switch (escape)
+				{
+					case '"':	out += '"';		break;
+					case '\\':	out += '\\';	break;
+					case '/':	out += '/';		break;
+					case 'b':	out += '\b';	break;
+					case 'f':	out += '\f';	break;
+					case 'n':	out += '\n';	break;
+					case 'r':	out += '\r';	break;
+					case 't':	out += '\t';	break;
+					case 'u':
+					{
+						// the benchmark only escapes control characters this way
+						char hex[5] = { 0 };
+						strncpy(hex, myText + myPos, 4);
+
+						if (strlen(hex) != 4)
+							return fail("bad \\u escape");
+
+						out += static_cast<char>(strtol(hex, nullptr, 16));
+						myPos += 4;
+						break;
+					}
+					default:
+						return fail("bad escape in string");
+				}
+			}
+
+			myPos++;
+			return true;
+		}
+
+		bool
+		parseValue(JsonValue& value)
+		{
+			skipSpace();
+
+			char c = myText[myPos];
+
+			if (c == '{')
+			{
+				value.type = JsonValue::Type::Object;
+				myPos++;
+				skipSpace();
+
+				if (myText[myPos] == '}')
+				{
+					myPos++;
+					return true;
+				}
+
+				while (true)
+				{
+					skipSpace();
+
+					if (myText[myPos] != '"')
+						return fail("expected a member name");
+
+					std::pair<std::string, JsonValue> member;
+
+					if (!parseString(member.first))
+						return false;
+
+					skipSpace();
+
+					if (myText[myPos++] != ':')
+						return fail("expected ':'");
+
+					if (!parseValue(member.second))
+						return false;
+
+					value.members.push_back(std::move(member));
+					skipSpace();
+
+					if (myText[myPos] == ',')
+						myPos++;
+					else if (myText[myPos] == '}')
+					{
+						myPos++;
+						return true;
+					}
+					else
+						return fail("expected ',' or '}'");
+				}
+			}
+
+			if (c == '[')
+			{
+				value.type = JsonValue::Type::Array;
+				myPos++;
+				skipSpace();
+
+				if (myText[myPos] == ']')
+				{
+					myPos++;
+					return true;
+				}
+
+				while (true)
+				{
+					value.items.emplace_back();
+
+					if (!parseValue(value.items.back()))
+						return false;
+
+					skipSpace();
+
+					if (myText[myPos] == ',')
+						myPos++;
+					else if (myText[myPos] == ']')
+					{
+						myPos++;
+						return true;
+					}
+					else
+						return fail("expected ',' or ']'");
+				}
+			}
+
+			if (c == '"')
+			{
+				value.type = JsonValue::Type::String;
+				return parseString(value.string);
+			}
+
+			if (match("true"))
+			{
+				value.type = JsonValue::Type::Bool;
+				value.boolean = true;
+				return true;
+			}
+
+			if (match("false"))
+			{
+				value.type = JsonValue::Type::Bool;
+				value.boolean = false;
+				return true;
+			}
+
+			if (match("null"))
+			{
+				value.type = JsonValue::Type::Null;
+				return true;
+			}
+
+			char* end = nullptr;
+			value.number = strtod(myText + myPos, &end);
+
+			if (end == myText + myPos)
+				return fail("expected a value");
+
+			value.type = JsonValue::Type::Number;
+			myPos = end - myText;
+			return true;
+		}
+
+		const char*		myText;
+		size_t			myPos;
+		std::string		myError;
+	};
+}
+
+const JsonValue*
+JsonValue::find(const char* name) const
+{
+	for (const auto& member : members)
+	{
+		if (member.first == name)
+			return &member.second;
+	}
+
+	return nullptr;
+}
+
+bool
+Json::parse(const std::string& text, JsonValue& value, std::string& error)
+{
+	value = JsonValue();
+
+	JsonParser parser(text);
+	return parser.parseDocument(value, error);
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+// Just enough JSON to read back the results the benchmark writes
+
+struct JsonValue
+{
+	enum class Type
+	{
+		Null,
+		Bool,
+		Number,
+		String,
+		Array,
+		Object,
+	};
+
+	// Returns the member called 'name' of an object, nullptr if there is none
+	const JsonValue*	find(const char* name) const;
+
+	Type			type = Type::Null;
+	bool			boolean = false;
+	double			number = 0.0;
+	std::string		string;
+
+	std::vector<JsonValue>								items;
+	std::vector<std::pair<std::string, JsonValue>>		members;
+};
+
+namespace Json
+{
+	// Returns false, with the reason in 'error', if 'text' isn't valid JSON
+	bool		parse(const std::string& text, JsonValue& value, std::string& error);
+}
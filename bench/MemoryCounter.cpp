@@ -0,0 +1,143 @@
+#include "MemoryCounter.h"
+
+#include <atomic>
+#include <new>
+#include <stdlib.h>
+
+namespace
+{
+	std::atomic<size_t>	theCurrentBytes(0);
+	std::atomic<size_t>	thePeakBytes(0);
+	std::atomic<size_t>	theAllocations(0);
+
+	// every block starts with its size, padded to keep the alignment of malloc
+	const size_t		HeaderSize = 16;
+
+	void*
+	allocate(size_t size)
+	{
+		void* block = malloc(size + HeaderSize);
+
+		if (!block)
+			return nullptr;
+
+		*static_cast<size_t*>(block) = size;
+
+		theAllocations++;
+
+		size_t current = theCurrentBytes.fetch_add(size) + size;
+		size_t peak = thePeakBytes.load();
+
+		while (current > peak && !thePeakBytes.compare_exchange_weak(peak, current))
+		{
+		}
+
+		return static_cast<char*>(block) + HeaderSize;
+	}
+
+	void
+	deallocate(void* p)
+	{
+		if (!p)
+			return;
+
+		void* block = static_cast<char*>(p) - HeaderSize;
+
+		theCurrentBytes.fetch_sub(*static_cast<size_t*>(block));
+		free(block);
+	}
+}
+
+size_t
+MemoryCounter::getCurrentBytes()
+{
+	return theCurrentBytes.load();
+}
+
+size_t
+MemoryCounter::getPeakBytes()
+{
+	return thePeakBytes.load();
+}
+
+void
+MemoryCounter::resetPeak()
+{
+	thePeakBytes.store(theCurrentBytes.load());
+}
+
+size_t
+MemoryCounter::getAllocations()
+{
+	return theAllocations.load();
+}
+
+void*
+operator new(size_t size)
+{
+	void* p = allocate(size);
+
+	if (!p)
+		throw std::bad_alloc();
+
+	return p;
+}
+
+void*
+operator new[](size_t size)
+{
+	void* p = allocate(size);
+
+	if (!p)
+		throw std::bad_alloc();
+
+	return p;
+}
+
+void*
+operator new(size_t size, const std::nothrow_t&) noexcept
+{
+	return allocate(size);
+}
+
+void*
+operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+	return allocate(size);
+}
+
+void
+operator delete(void* p) noexcept
+{
+	deallocate(p);
+}
+
+void
+operator delete[](void* p) noexcept
+{
+	deallocate(p);
+}
+
+void
+operator delete(void* p, size_t) noexcept
+{
+	deallocate(p);
+}
+
+void
+operator delete[](void* p, size_t) noexcept
+{
+	deallocate(p);
+}
+
+void
+operator delete(void* p, const std::nothrow_t&) noexcept
+{
+	deallocate(p);
+}
+
+void
+operator delete[](void* p, const std::nothrow_t&) noexcept
+{
+	deallocate(p);
+}
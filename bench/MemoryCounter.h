@@ -0,0 +1,20 @@
+#pragma once
+
+#include <stddef.h>
+
+// Counts the bytes allocated with operator new in the benchmark, the node and
+// quickhull included, by replacing the global operator new and delete.
+
+namespace MemoryCounter
+{
+	// bytes allocated and not freed yet
+	size_t		getCurrentBytes();
+
+	// highest getCurrentBytes() since the last resetPeak()
+	size_t		getPeakBytes();
+
+	void		resetPeak();
+
+	// number of operator new calls since the start
+	size_t		getAllocations();
+}
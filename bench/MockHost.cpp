@@ -0,0 +1,989 @@
+#include "MockHost.h"
+
+#include <algorithm>
+#include <stdlib.h>
+#include <string.h>
+
+//-----------------------------------------------------------------------------------------------------
+//										MockString
+//-----------------------------------------------------------------------------------------------------
+
+void
+MockString::setString(const char* data)
+{
+	value = data ? data : "";
+}
+
+//-----------------------------------------------------------------------------------------------------
+//										MockSOPInput
+//-----------------------------------------------------------------------------------------------------
+
+MockSOPInput::MockSOPInput() :
+	numTexLayers(0)
+{
+	opPath = "/bench/input";
+	opId = 1;
+	myPrimsInfo = nullptr;
+	myPrimPointIndices = nullptr;
+	totalCooks = 0;
+}
+
+void
+MockSOPInput::clear()
+{
+	points.clear();
+	normals.clear();
+	colors.clear();
+	texCoords.clear();
+	numTexLayers = 0;
+
+	myIndices.clear();
+	myPrimSizes.clear();
+	myAttributes.clear();
+}
+
+void
+MockSOPInput::addTriangle(int32_t a, int32_t b, int32_t c)
+{
+	myIndices.push_back(a);
+	myIndices.push_back(b);
+	myIndices.push_back(c);
+	myPrimSizes.push_back(3);
+}
+
+void
+MockSOPInput::addPolygon(const std::vector<int32_t>& indices)
+{
+	myIndices.insert(myIndices.end(), indices.begin(), indices.end());
+	myPrimSizes.push_back(static_cast<int32_t>(indices.size()));
+}
+
+void
+MockSOPInput::addAttribute(const char* name, int32_t numComponents, const std::vector<float>& values)
+{
+	Attribute attribute;
+	attribute.name = name;
+	attribute.numComponents = numComponents;
+	attribute.floats = values;
+
+	myAttributes.push_back(attribute);
+}
+
+void
+MockSOPInput::addAttribute(const char* name, int32_t numComponents, const std::vector<int32_t>& values)
+{
+	Attribute attribute;
+	attribute.name = name;
+	attribute.numComponents = numComponents;
+	attribute.ints = values;
+
+	myAttributes.push_back(attribute);
+}
+
+void
+MockSOPInput::finalize()
+{
+	int32_t numPrims = static_cast<int32_t>(myPrimSizes.size());
+	int32_t offset = 0;
+
+	myPrims.resize(numPrims);
+
+	for (int32_t i = 0; i < numPrims; i++)
+	{
+		myPrims[i].numVertices = myPrimSizes[i];
+		myPrims[i].pointIndices = myIndices.data() + offset;
+		myPrims[i].type = PrimitiveType::Polygon;
+		myPrims[i].pointIndicesOffset = offset;
+
+		offset += myPrimSizes[i];
+	}
+
+	myPrimsInfo = myPrims.data();
+	myPrimPointIndices = myIndices.data();
+
+	myAttributeData.clear();
+
+	for (const Attribute& attribute : myAttributes)
+	{
+		SOP_CustomAttribData data(attribute.name.c_str(), attribute.numComponents,
+		                          attribute.ints.empty() ? AttribType::Float : AttribType::Int);
+		data.floatData = attribute.floats.empty() ? nullptr : attribute.floats.data();
+		data.intData = attribute.ints.empty() ? nullptr : attribute.ints.data();
+
+		myAttributeData.push_back(data);
+	}
+
+	myNormalInfo.numNormals = static_cast<int32_t>(normals.size());
+	myNormalInfo.normals = normals.data();
+
+	myColorInfo.numColors = static_cast<int32_t>(colors.size());
+	myColorInfo.colors = colors.data();
+
+	myTextureInfo.numTextures = static_cast<int32_t>(texCoords.size());
+	myTextureInfo.textures = texCoords.data();
+	myTextureInfo.numTextureLayers = numTexLayers;
+
+	totalCooks++;
+}
+
+int32_t
+MockSOPInput::getNumPoints() const
+{
+	return static_cast<int32_t>(points.size());
+}
+
+int32_t
+MockSOPInput::getNumVertices() const
+{
+	return static_cast<int32_t>(myIndices.size());
+}
+
+int32_t
+MockSOPInput::getNumPrimitives() const
+{
+	return static_cast<int32_t>(myPrims.size());
+}
+
+int32_t
+MockSOPInput::getNumCustomAttributes() const
+{
+	return static_cast<int32_t>(myAttributeData.size());
+}
+
+const Position*
+MockSOPInput::getPointPositions() const
+{
+	return points.data();
+}
+
+const SOP_NormalInfo*
+MockSOPInput::getNormals() const
+{
+	return normals.empty() ? nullptr : &myNormalInfo;
+}
+
+const SOP_ColorInfo*
+MockSOPInput::getColors() const
+{
+	return colors.empty() ? nullptr : &myColorInfo;
+}
+
+const SOP_TextureInfo*
+MockSOPInput::getTextures() const
+{
+	return texCoords.empty() ? nullptr : &myTextureInfo;
+}
+
+const SOP_CustomAttribData*
+MockSOPInput::getCustomAttribute(int32_t customAttribIndex) const
+{
+	if (customAttribIndex < 0 || customAttribIndex >= getNumCustomAttributes())
+		return nullptr;
+
+	return &myAttributeData[customAttribIndex];
+}
+
+const SOP_CustomAttribData*
+MockSOPInput::getCustomAttribute(const char* customAttribName) const
+{
+	for (const SOP_CustomAttribData& data : myAttributeData)
+	{
+		if (strcmp(data.name, customAttribName) == 0)
+			return &data;
+	}
+
+	return nullptr;
+}
+
+bool
+MockSOPInput::hasNormals() const
+{
+	return !normals.empty();
+}
+
+bool
+MockSOPInput::hasColors() const
+{
+	return !colors.empty();
+}
+
+//-----------------------------------------------------------------------------------------------------
+//										MockInputs
+//-----------------------------------------------------------------------------------------------------
+
+MockInputs::MockInputs() :
+	sop(nullptr)
+{
+	memset(&time, 0, sizeof(time));
+	time.rate = 60.0;
+	time.rootRate = 60.0;
+	time.deltaFrames = 1.0;
+	time.deltaMS = 1000.0 / 60.0;
+}
+
+int32_t
+MockInputs::getNumInputs() const
+{
+	return sop ? 1 : 0;
+}
+
+const OP_SOPInput*
+MockInputs::getInputSOP(int32_t index) const
+{
+	return index == 0 ? sop : nullptr;
+}
+
+double
+MockInputs::getParDouble(const char* name, int32_t index) const
+{
+	auto it = pars.find(name);
+
+	return it == pars.end() ? 0.0 : it->second;
+}
+
+int32_t
+MockInputs::getParInt(const char* name, int32_t index) const
+{
+	return static_cast<int32_t>(getParDouble(name, index));
+}
+
+const char*
+MockInputs::getParString(const char* name) const
+{
+	auto it = strings.find(name);
+
+	return it == strings.end() ? "" : it->second.c_str();
+}
+
+const char*
+MockInputs::getParFilePath(const char* name) const
+{
+	return getParString(name);
+}
+
+const OP_TimeInfo*
+MockInputs::getTimeInfo() const
+{
+	return &time;
+}
+
+//-----------------------------------------------------------------------------------------------------
+//										MockSOPOutput
+//-----------------------------------------------------------------------------------------------------
+
+void
+MockSOPOutput::clear()
+{
+	points.clear();
+	normals.clear();
+	colors.clear();
+	texCoords.clear();
+	numTexLayers = 0;
+
+	triangles.clear();
+	lines.clear();
+
+	floatAttributes.clear();
+	intAttributes.clear();
+	pointGroups.clear();
+	primGroups.clear();
+
+	hasBoundingBox = false;
+}
+
+int32_t
+MockSOPOutput::addPoint(const Position& pos)
+{
+	points.push_back(pos);
+	return static_cast<int32_t>(points.size()) - 1;
+}
+
+bool
+MockSOPOutput::addPoints(const Position* pos, int32_t numPoints)
+{
+	points.insert(points.end(), pos, pos + numPoints);
+	return true;
+}
+
+int32_t
+MockSOPOutput::getNumPoints()
+{
+	return static_cast<int32_t>(points.size());
+}
+
+bool
+MockSOPOutput::setNormal(const Vector& n, int32_t pointIdx)
+{
+	return setNormals(&n, 1, pointIdx);
+}
+
+bool
+MockSOPOutput::setNormals(const Vector* n, int32_t numPoints, int32_t startPointIdx)
+{
+	if (startPointIdx < 0 || startPointIdx + numPoints > getNumPoints())
+		return false;
+
+	normals.resize(points.size());
+	std::copy(n, n + numPoints, normals.begin() + startPointIdx);
+	return true;
+}
+
+bool
+MockSOPOutput::hasNormal()
+{
+	return !normals.empty();
+}
+
+bool
+MockSOPOutput::setColor(const Color& c, int32_t pointIdx)
+{
+	return setColors(&c, 1, pointIdx);
+}
+
+bool
+MockSOPOutput::setColors(const Color* c, int32_t numPoints, int32_t startPointIdx)
+{
+	if (startPointIdx < 0 || startPointIdx + numPoints > getNumPoints())
+		return false;
+
+	colors.resize(points.size());
+	std::copy(c, c + numPoints, colors.begin() + startPointIdx);
+	return true;
+}
+
+bool
+MockSOPOutput::hasColor()
+{
+	return !colors.empty();
+}
+
+bool
+MockSOPOutput::setTexCoord(const TexCoord* tex, int32_t numLayers, int32_t pointIdx)
+{
+	return setTexCoords(tex, 1, numLayers, pointIdx);
+}
+
+bool
+MockSOPOutput::setTexCoords(const TexCoord* t, int32_t numPoints, int32_t numLayers, int32_t startPointIdx)
+{
+	if (startPointIdx < 0 || startPointIdx + numPoints > getNumPoints())
+		return false;
+
+	numTexLayers = numLayers;
+	texCoords.resize(points.size() * numLayers);
+	std::copy(t, t + numPoints * numLayers, texCoords.begin() + startPointIdx * numLayers);
+	return true;
+}
+
+bool
+MockSOPOutput::hasTexCoord()
+{
+	return !texCoords.empty();
+}
+
+int32_t
+MockSOPOutput::getNumTexCoordLayers()
+{
+	return numTexLayers;
+}
+
+bool
+MockSOPOutput::setCustomAttribute(const SOP_CustomAttribData* cu, int32_t numPoints)
+{
+	size_t size = static_cast<size_t>(numPoints) * cu->numComponents;
+
+	if (cu->attribType == AttribType::Float)
+		floatAttributes[cu->name].assign(cu->floatData, cu->floatData + size);
+	else
+		intAttributes[cu->name].assign(cu->intData, cu->intData + size);
+
+	return true;
+}
+
+bool
+MockSOPOutput::hasCustomAttibutes()
+{
+	return !floatAttributes.empty() || !intAttributes.empty();
+}
+
+bool
+MockSOPOutput::addTriangle(int32_t ptIdx1, int32_t ptIdx2, int32_t ptIdx3)
+{
+	triangles.push_back(ptIdx1);
+	triangles.push_back(ptIdx2);
+	triangles.push_back(ptIdx3);
+	return true;
+}
+
+bool
+MockSOPOutput::addTriangles(const int32_t* indices, int32_t size)
+{
+	triangles.insert(triangles.end(), indices, indices + size * 3);
+	return true;
+}
+
+bool
+MockSOPOutput::addParticleSystem(int32_t numParticles, int32_t startIndex)
+{
+	return true;
+}
+
+bool
+MockSOPOutput::addLine(const int32_t* indices, int32_t size)
+{
+	lines.emplace_back(indices, indices + size);
+	return true;
+}
+
+bool
+MockSOPOutput::addLines(const int32_t* indices, int32_t* sizeOfEachLine, int32_t numOfLines)
+{
+	for (int32_t i = 0; i < numOfLines; i++)
+	{
+		addLine(indices, sizeOfEachLine[i]);
+		indices += sizeOfEachLine[i];
+	}
+
+	return true;
+}
+
+int32_t
+MockSOPOutput::getNumPrimitives()
+{
+	return static_cast<int32_t>(triangles.size() / 3 + lines.size());
+}
+
+bool
+MockSOPOutput::setBoundingBox(const BoundingBox& bbox)
+{
+	hasBoundingBox = true;
+	boundingBox = bbox;
+	return true;
+}
+
+bool
+MockSOPOutput::addGroup(const SOP_GroupType& type, const char* name)
+{
+	std::map<std::string, std::vector<int>>& groups = type == SOP_GroupType::Point ? pointGroups : primGroups;
+
+	if (groups.count(name))
+		return false;
+
+	groups[name];
+	return true;
+}
+
+bool
+MockSOPOutput::destroyGroup(const SOP_GroupType& type, const char* name)
+{
+	std::map<std::string, std::vector<int>>& groups = type == SOP_GroupType::Point ? pointGroups : primGroups;
+
+	return groups.erase(name) > 0;
+}
+
+bool
+MockSOPOutput::addPointToGroup(int index, const char* name)
+{
+	return addToGroup(index, SOP_GroupType::Point, name);
+}
+
+bool
+MockSOPOutput::addPrimToGroup(int index, const char* name)
+{
+	return addToGroup(index, SOP_GroupType::Primitive, name);
+}
+
+bool
+MockSOPOutput::addToGroup(int index, const SOP_GroupType& type, const char* name)
+{
+	std::map<std::string, std::vector<int>>& groups = type == SOP_GroupType::Point ? pointGroups : primGroups;
+
+	auto it = groups.find(name);
+
+	if (it == groups.end())
+		return false;
+
+	it->second.push_back(index);
+	return true;
+}
+
+bool
+MockSOPOutput::discardFromPointGroup(int index, const char* name)
+{
+	return discardFromGroup(index, SOP_GroupType::Point, name);
+}
+
+bool
+MockSOPOutput::discardFromPrimGroup(int index, const char* name)
+{
+	return discardFromGroup(index, SOP_GroupType::Primitive, name);
+}
+
+bool
+MockSOPOutput::discardFromGroup(int index, const SOP_GroupType& type, const char* name)
+{
+	std::map<std::string, std::vector<int>>& groups = type == SOP_GroupType::Point ? pointGroups : primGroups;
+
+	auto it = groups.find(name);
+
+	if (it == groups.end())
+		return false;
+
+	std::vector<int>& members = it->second;
+	members.erase(std::remove(members.begin(), members.end(), index), members.end());
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------------
+//										MockVBOOutput
+//-----------------------------------------------------------------------------------------------------
+
+void
+MockVBOOutput::clear()
+{
+	normalEnabled = false;
+	colorEnabled = false;
+	numTexLayers = 0;
+
+	positions.clear();
+	normals.clear();
+	colors.clear();
+	texCoords.clear();
+
+	triangles.clear();
+	lines.clear();
+	particles.clear();
+
+	customAttributes.clear();
+
+	complete = false;
+}
+
+void
+MockVBOOutput::enableNormal()
+{
+	normalEnabled = true;
+}
+
+void
+MockVBOOutput::enableColor()
+{
+	colorEnabled = true;
+}
+
+void
+MockVBOOutput::enableTexCoord(int32_t numLayers)
+{
+	numTexLayers = numLayers;
+}
+
+bool
+MockVBOOutput::hasNormal()
+{
+	return normalEnabled;
+}
+
+bool
+MockVBOOutput::hasColor()
+{
+	return colorEnabled;
+}
+
+bool
+MockVBOOutput::hasTexCoord()
+{
+	return numTexLayers > 0;
+}
+
+bool
+MockVBOOutput::hasCustomAttibutes()
+{
+	return !customAttributes.empty();
+}
+
+bool
+MockVBOOutput::addCustomAttribute(const SOP_CustomAttribInfo& attr)
+{
+	for (const CustomAttribute& attribute : customAttributes)
+	{
+		if (attribute.name == attr.name)
+			return false;
+	}
+
+	CustomAttribute attribute;
+	attribute.name = attr.name;
+	attribute.numComponents = attr.numComponents;
+	attribute.type = attr.attribType;
+
+	customAttributes.push_back(attribute);
+	return true;
+}
+
+void
+MockVBOOutput::allocVBO(int32_t numVertices, int32_t numIndices, VBOBufferMode bufferMode)
+{
+	positions.assign(numVertices, Position());
+	normals.assign(normalEnabled ? numVertices : 0, Vector());
+	colors.assign(colorEnabled ? numVertices : 0, Color());
+	texCoords.assign(static_cast<size_t>(numVertices) * numTexLayers, TexCoord());
+
+	for (CustomAttribute& attribute : customAttributes)
+	{
+		size_t size = static_cast<size_t>(numVertices) * attribute.numComponents;
+
+		attribute.floats.assign(attribute.type == AttribType::Float ? size : 0, 0.0f);
+		attribute.ints.assign(attribute.type == AttribType::Int ? size : 0, 0);
+	}
+
+	triangles.clear();
+	lines.clear();
+	particles.clear();
+
+	triangles.reserve(numIndices);
+	mode = bufferMode;
+	complete = false;
+}
+
+Position*
+MockVBOOutput::getPos()
+{
+	return positions.data();
+}
+
+Vector*
+MockVBOOutput::getNormals()
+{
+	return normalEnabled ? normals.data() : nullptr;
+}
+
+Color*
+MockVBOOutput::getColors()
+{
+	return colorEnabled ? colors.data() : nullptr;
+}
+
+TexCoord*
+MockVBOOutput::getTexCoords()
+{
+	return numTexLayers > 0 ? texCoords.data() : nullptr;
+}
+
+int32_t
+MockVBOOutput::getNumTexCoordLayers()
+{
+	return numTexLayers;
+}
+
+int32_t*
+MockVBOOutput::addTriangles(int32_t numTriangles)
+{
+	size_t start = triangles.size();
+	triangles.resize(start + numTriangles * 3);
+	return triangles.data() + start;
+}
+
+int32_t*
+MockVBOOutput::addParticleSystem(int32_t numParticles)
+{
+	size_t start = particles.size();
+	particles.resize(start + numParticles);
+	return particles.data() + start;
+}
+
+int32_t*
+MockVBOOutput::addLines(int32_t numIndices)
+{
+	size_t start = lines.size();
+	lines.resize(start + numIndices);
+	return lines.data() + start;
+}
+
+bool
+MockVBOOutput::getCustomAttribute(SOP_CustomAttribData* cu, const char* name)
+{
+	if (!cu || !name)
+		return false;
+
+	for (CustomAttribute& attribute : customAttributes)
+	{
+		if (attribute.name != name)
+			continue;
+
+		cu->name = attribute.name.c_str();
+		cu->numComponents = attribute.numComponents;
+		cu->attribType = attribute.type;
+		cu->floatData = attribute.floats.empty() ? nullptr : attribute.floats.data();
+		cu->intData = attribute.ints.empty() ? nullptr : attribute.ints.data();
+		return true;
+	}
+
+	return false;
+}
+
+bool
+MockVBOOutput::setBoundingBox(const BoundingBox& bbox)
+{
+	return true;
+}
+
+void
+MockVBOOutput::updateComplete()
+{
+	complete = true;
+}
+
+//-----------------------------------------------------------------------------------------------------
+//										MockParameterManager
+//-----------------------------------------------------------------------------------------------------
+
+OP_ParAppendResult
+MockParameterManager::appendNumeric(const OP_NumericParameter& np)
+{
+	if (myDefaults.count(np.name) || myStringDefaults.count(np.name))
+		return OP_ParAppendResult::InvalidName;
+
+	myDefaults[np.name] = np.defaultValues[0];
+	return OP_ParAppendResult::Success;
+}
+
+OP_ParAppendResult
+MockParameterManager::appendText(const OP_StringParameter& sp)
+{
+	if (myDefaults.count(sp.name) || myStringDefaults.count(sp.name))
+		return OP_ParAppendResult::InvalidName;
+
+	myStringDefaults[sp.name] = sp.defaultValue ? sp.defaultValue : "";
+	return OP_ParAppendResult::Success;
+}
+
+OP_ParAppendResult
+MockParameterManager::appendFloat(const OP_NumericParameter& np, int32_t size)
+{
+	return appendNumeric(np);
+}
+
+OP_ParAppendResult
+MockParameterManager::appendInt(const OP_NumericParameter& np, int32_t size)
+{
+	return appendNumeric(np);
+}
+
+OP_ParAppendResult
+MockParameterManager::appendXY(const OP_NumericParameter& np)
+{
+	return appendNumeric(np);
+}
+
+OP_ParAppendResult
+MockParameterManager::appendXYZ(const OP_NumericParameter& np)
+{
+	return appendNumeric(np);
+}
+
+OP_ParAppendResult
+MockParameterManager::appendUV(const OP_NumericParameter& np)
+{
+	return appendNumeric(np);
+}
+
+OP_ParAppendResult
+MockParameterManager::appendUVW(const OP_NumericParameter& np)
+{
+	return appendNumeric(np);
+}
+
+OP_ParAppendResult
+MockParameterManager::appendRGB(const OP_NumericParameter& np)
+{
+	return appendNumeric(np);
+}
+
+OP_ParAppendResult
+MockParameterManager::appendRGBA(const OP_NumericParameter& np)
+{
+	return appendNumeric(np);
+}
+
+OP_ParAppendResult
+MockParameterManager::appendToggle(const OP_NumericParameter& np)
+{
+	return appendNumeric(np);
+}
+
+OP_ParAppendResult
+MockParameterManager::appendPulse(const OP_NumericParameter& np)
+{
+	return appendNumeric(np);
+}
+
+OP_ParAppendResult
+MockParameterManager::appendMomentary(const OP_NumericParameter& np)
+{
+	return appendNumeric(np);
+}
+
+OP_ParAppendResult
+MockParameterManager::appendWH(const OP_NumericParameter& np)
+{
+	return appendNumeric(np);
+}
+
+OP_ParAppendResult
+MockParameterManager::appendString(const OP_StringParameter& sp)
+{
+	return appendText(sp);
+}
+
+OP_ParAppendResult
+MockParameterManager::appendFile(const OP_StringParameter& sp)
+{
+	return appendText(sp);
+}
+
+OP_ParAppendResult
+MockParameterManager::appendFolder(const OP_StringParameter& sp)
+{
+	return appendText(sp);
+}
+
+OP_ParAppendResult
+MockParameterManager::appendDAT(const OP_StringParameter& sp)
+{
+	return appendText(sp);
+}
+
+OP_ParAppendResult
+MockParameterManager::appendCHOP(const OP_StringParameter& sp)
+{
+	return appendText(sp);
+}
+
+OP_ParAppendResult
+MockParameterManager::appendTOP(const OP_StringParameter& sp)
+{
+	return appendText(sp);
+}
+
+OP_ParAppendResult
+MockParameterManager::appendObject(const OP_StringParameter& sp)
+{
+	return appendText(sp);
+}
+
+OP_ParAppendResult
+MockParameterManager::appendSOP(const OP_StringParameter& sp)
+{
+	return appendText(sp);
+}
+
+OP_ParAppendResult
+MockParameterManager::appendPython(const OP_StringParameter& sp)
+{
+	return appendText(sp);
+}
+
+OP_ParAppendResult
+MockParameterManager::appendOP(const OP_StringParameter& sp)
+{
+	return appendText(sp);
+}
+
+OP_ParAppendResult
+MockParameterManager::appendCOMP(const OP_StringParameter& sp)
+{
+	return appendText(sp);
+}
+
+OP_ParAppendResult
+MockParameterManager::appendMAT(const OP_StringParameter& sp)
+{
+	return appendText(sp);
+}
+
+OP_ParAppendResult
+MockParameterManager::appendPanelCOMP(const OP_StringParameter& sp)
+{
+	return appendText(sp);
+}
+
+OP_ParAppendResult
+MockParameterManager::appendHeader(const OP_StringParameter& sp)
+{
+	return appendText(sp);
+}
+
+OP_ParAppendResult
+MockParameterManager::appendMenu(const OP_StringParameter& sp, int32_t nItems,
+								const char** names, const char** labels)
+{
+	if (myDefaults.count(sp.name) || myStringDefaults.count(sp.name))
+		return OP_ParAppendResult::InvalidName;
+
+	std::vector<std::string>& items = myMenus[sp.name];
+	items.assign(names, names + nItems);
+
+	// getParInt() of a menu is the index of its item
+	int32_t defaultIndex = 0;
+
+	for (int32_t i = 0; i < nItems; i++)
+	{
+		if (sp.defaultValue && items[i] == sp.defaultValue)
+			defaultIndex = i;
+	}
+
+	myDefaults[sp.name] = defaultIndex;
+	return OP_ParAppendResult::Success;
+}
+
+OP_ParAppendResult
+MockParameterManager::appendStringMenu(const OP_StringParameter& sp, int32_t nItems,
+								const char** names, const char** labels)
+{
+	return appendText(sp);
+}
+
+void
+MockParameterManager::applyDefaults(MockInputs& inputs) const
+{
+	for (const auto& par : myDefaults)
+	{
+		inputs.pars[par.first] = par.second;
+	}
+
+	for (const auto& par : myStringDefaults)
+	{
+		inputs.strings[par.first] = par.second;
+	}
+}
+
+bool
+MockParameterManager::set(MockInputs& inputs, const std::string& name, const std::string& value) const
+{
+	auto menu = myMenus.find(name);
+
+	if (menu != myMenus.end())
+	{
+		for (size_t i = 0; i < menu->second.size(); i++)
+		{
+			if (menu->second[i] == value)
+			{
+				inputs.pars[name] = static_cast<double>(i);
+				return true;
+			}
+		}
+	}
+
+	if (myStringDefaults.count(name))
+	{
+		inputs.strings[name] = value;
+		return true;
+	}
+
+	if (myDefaults.count(name))
+	{
+		inputs.pars[name] = atof(value.c_str());
+		return true;
+	}
+
+	return false;
+}
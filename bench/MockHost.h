@@ -0,0 +1,321 @@
+#pragma once
+
+#include "SOP_CPlusPlusBase.h"
+#include <map>
+#include <string>
+#include <vector>
+
+// Stand-ins for the classes TouchDesigner hands to a SOP plugin, enough to
+// run execute() and executeVBO() outside of it. They keep everything in
+// plain vectors so the benchmark can fill the input and read the output.
+
+class MockString : public OP_String
+{
+public:
+
+	virtual void	setString(const char* data) override;
+
+	std::string		value;
+};
+
+// Input SOP: points, triangles and custom point attributes
+class MockSOPInput : public OP_SOPInput
+{
+public:
+
+	MockSOPInput();
+
+	// Removes the points, primitives and attributes, finalize() must be
+	// called after
+	void			clear();
+
+	// Adds a triangle primitive, finalize() must be called after
+	void			addTriangle(int32_t a, int32_t b, int32_t c);
+
+	// Adds a polygon primitive of any size, finalize() must be called after
+	void			addPolygon(const std::vector<int32_t>& indices);
+
+	// Adds a point attribute of 'numComponents' values per point
+	void			addAttribute(const char* name, int32_t numComponents, const std::vector<float>& values);
+	void			addAttribute(const char* name, int32_t numComponents, const std::vector<int32_t>& values);
+
+	// Points the SOP structures at the vectors, and counts a cook of the
+	// input. Must be called after any change and before the next cook.
+	void			finalize();
+
+	virtual int32_t		getNumPoints() const override;
+	virtual int32_t		getNumVertices() const override;
+	virtual int32_t		getNumPrimitives() const override;
+	virtual int32_t		getNumCustomAttributes() const override;
+
+	virtual const Position*		getPointPositions() const override;
+	virtual const SOP_NormalInfo*	getNormals() const override;
+	virtual const SOP_ColorInfo*	getColors() const override;
+	virtual const SOP_TextureInfo*	getTextures() const override;
+
+	virtual const SOP_CustomAttribData*	getCustomAttribute(int32_t customAttribIndex) const override;
+	virtual const SOP_CustomAttribData*	getCustomAttribute(const char* customAttribName) const override;
+
+	virtual bool	hasNormals() const override;
+	virtual bool	hasColors() const override;
+
+	virtual bool	isInside(const Position& pos) override { return false; }
+	virtual bool	sendRay(const Position&, const Vector&, Position&, float&, Vector&, float&, float&, int&) override { return false; }
+
+	std::vector<Position>	points;
+	std::vector<Vector>		normals;
+	std::vector<Color>		colors;
+	std::vector<TexCoord>	texCoords;
+	int32_t					numTexLayers;
+
+private:
+
+	struct Attribute
+	{
+		std::string				name;
+		int32_t					numComponents;
+		std::vector<float>		floats;
+		std::vector<int32_t>	ints;
+	};
+
+	std::vector<int32_t>			myIndices;
+	std::vector<int32_t>			myPrimSizes;
+	std::vector<SOP_PrimitiveInfo>	myPrims;
+	std::vector<Attribute>			myAttributes;
+	std::vector<SOP_CustomAttribData>	myAttributeData;
+
+	SOP_NormalInfo		myNormalInfo;
+	SOP_ColorInfo		myColorInfo;
+	SOP_TextureInfo		myTextureInfo;
+};
+
+// Parameters are looked up by name in 'pars' (numbers, toggles and menu
+// indices) and 'strings'
+class MockInputs : public OP_Inputs
+{
+public:
+
+	MockInputs();
+
+	virtual int32_t		getNumInputs() const override;
+	virtual const OP_SOPInput*	getInputSOP(int32_t index) const override;
+
+	virtual double		getParDouble(const char* name, int32_t index = 0) const override;
+	virtual int32_t		getParInt(const char* name, int32_t index = 0) const override;
+	virtual const char*	getParString(const char* name) const override;
+	virtual const char*	getParFilePath(const char* name) const override;
+	virtual const OP_TimeInfo*	getTimeInfo() const override;
+
+	virtual const OP_TOPInput*	getInputTOP(int32_t) const override { return nullptr; }
+	virtual const OP_CHOPInput*	getInputCHOP(int32_t) const override { return nullptr; }
+	virtual const OP_DATInput*	getInputDAT(int32_t) const override { return nullptr; }
+	virtual const OP_DATInput*	getParDAT(const char*) const override { return nullptr; }
+	virtual const OP_TOPInput*	getParTOP(const char*) const override { return nullptr; }
+	virtual const OP_CHOPInput*	getParCHOP(const char*) const override { return nullptr; }
+	virtual const OP_ObjectInput*	getParObject(const char*) const override { return nullptr; }
+	virtual const OP_SOPInput*	getParSOP(const char*) const override { return nullptr; }
+	virtual bool		getParDouble2(const char*, double&, double&) const override { return false; }
+	virtual bool		getParDouble3(const char*, double&, double&, double&) const override { return false; }
+	virtual bool		getParDouble4(const char*, double&, double&, double&, double&) const override { return false; }
+	virtual bool		getParInt2(const char*, int32_t&, int32_t&) const override { return false; }
+	virtual bool		getParInt3(const char*, int32_t&, int32_t&, int32_t&) const override { return false; }
+	virtual bool		getParInt4(const char*, int32_t&, int32_t&, int32_t&, int32_t&) const override { return false; }
+	virtual bool		getRelativeTransform(const char*, const char*, double[4][4]) const override { return false; }
+	virtual void		enablePar(const char*, bool) const override {}
+	virtual const OP_DATInput*	getDAT(const char*) const override { return nullptr; }
+	virtual const OP_TOPInput*	getTOP(const char*) const override { return nullptr; }
+	virtual const OP_CHOPInput*	getCHOP(const char*) const override { return nullptr; }
+	virtual const OP_ObjectInput*	getObject(const char*) const override { return nullptr; }
+	virtual const OP_SOPInput*	getSOP(const char*) const override { return nullptr; }
+	virtual void*		getTOPDataInCPUMemory(const OP_TOPInput*, const OP_TOPInputDownloadOptions*) const override { return nullptr; }
+	virtual PyObject*	getParPython(const char*) const override { return nullptr; }
+
+	// nullptr means nothing is connected
+	const MockSOPInput*		sop;
+
+	std::map<std::string, double>		pars;
+	std::map<std::string, std::string>	strings;
+	OP_TimeInfo			time;
+};
+
+// Output SOP, everything added is kept
+class MockSOPOutput : public SOP_Output
+{
+public:
+
+	// Empties the output for the next cook, keeping the capacity of the
+	// buffers so that a reused output doesn't allocate once it has grown
+	void				clear();
+
+	virtual int32_t		addPoint(const Position& pos) override;
+	virtual bool		addPoints(const Position* pos, int32_t numPoints) override;
+	virtual int32_t		getNumPoints() override;
+
+	virtual bool		setNormal(const Vector& n, int32_t pointIdx) override;
+	virtual bool		setNormals(const Vector* n, int32_t numPoints, int32_t startPointIdx) override;
+	virtual bool		hasNormal() override;
+
+	virtual bool		setColor(const Color& c, int32_t pointIdx) override;
+	virtual bool		setColors(const Color* colors, int32_t numPoints, int32_t startPointIdx) override;
+	virtual bool		hasColor() override;
+
+	virtual bool		setTexCoord(const TexCoord* tex, int32_t numLayers, int32_t pointIdx) override;
+	virtual bool		setTexCoords(const TexCoord* t, int32_t numPoints, int32_t numLayers, int32_t startPointIdx) override;
+	virtual bool		hasTexCoord() override;
+	virtual int32_t		getNumTexCoordLayers() override;
+
+	virtual bool		setCustomAttribute(const SOP_CustomAttribData* cu, int32_t numPoints) override;
+	virtual bool		hasCustomAttibutes() override;
+
+	virtual bool		addTriangle(int32_t ptIdx1, int32_t ptIdx2, int32_t ptIdx3) override;
+	virtual bool		addTriangles(const int32_t* indices, int32_t size) override;
+	virtual bool		addParticleSystem(int32_t numParticles, int32_t startIndex) override;
+	virtual bool		addLine(const int32_t* indices, int32_t size) override;
+	virtual bool		addLines(const int32_t* indices, int32_t* sizeOfEachLine, int32_t numOfLines) override;
+	virtual int32_t		getNumPrimitives() override;
+
+	virtual bool		setBoundingBox(const BoundingBox& bbox) override;
+
+	virtual bool		addGroup(const SOP_GroupType& type, const char* name) override;
+	virtual bool		destroyGroup(const SOP_GroupType& type, const char* name) override;
+	virtual bool		addPointToGroup(int index, const char* name) override;
+	virtual bool		addPrimToGroup(int index, const char* name) override;
+	virtual bool		addToGroup(int index, const SOP_GroupType& type, const char* name) override;
+	virtual bool		discardFromPointGroup(int index, const char* name) override;
+	virtual bool		discardFromPrimGroup(int index, const char* name) override;
+	virtual bool		discardFromGroup(int index, const SOP_GroupType& type, const char* name) override;
+
+	std::vector<Position>	points;
+	std::vector<Vector>		normals;
+	std::vector<Color>		colors;
+	std::vector<TexCoord>	texCoords;
+	int32_t					numTexLayers = 0;
+
+	std::vector<int32_t>	triangles;
+	std::vector<std::vector<int32_t>>	lines;
+
+	std::map<std::string, std::vector<float>>	floatAttributes;
+	std::map<std::string, std::vector<int32_t>>	intAttributes;
+	std::map<std::string, std::vector<int>>		pointGroups;
+	std::map<std::string, std::vector<int>>		primGroups;
+
+	bool					hasBoundingBox = false;
+	BoundingBox				boundingBox = BoundingBox(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+};
+
+// VBO output, the buffers are plain vectors
+class MockVBOOutput : public SOP_VBOOutput
+{
+public:
+
+	// Like MockSOPOutput::clear()
+	void				clear();
+
+	virtual void		enableNormal() override;
+	virtual void		enableColor() override;
+	virtual void		enableTexCoord(int32_t numLayers = 0) override;
+	virtual bool		hasNormal() override;
+	virtual bool		hasColor() override;
+	virtual bool		hasTexCoord() override;
+	virtual bool		hasCustomAttibutes() override;
+	virtual bool		addCustomAttribute(const SOP_CustomAttribInfo& attr) override;
+
+	virtual void		allocVBO(int32_t numVertices, int32_t numIndices, VBOBufferMode mode) override;
+
+	virtual Position*	getPos() override;
+	virtual Vector*		getNormals() override;
+	virtual Color*		getColors() override;
+	virtual TexCoord*	getTexCoords() override;
+	virtual int32_t		getNumTexCoordLayers() override;
+
+	virtual int32_t*	addTriangles(int32_t numTriangles) override;
+	virtual int32_t*	addParticleSystem(int32_t numParticles) override;
+	virtual int32_t*	addLines(int32_t numIndices) override;
+
+	virtual bool		getCustomAttribute(SOP_CustomAttribData* cu, const char* name) override;
+	virtual bool		setBoundingBox(const BoundingBox& bbox) override;
+	virtual void		updateComplete() override;
+
+	bool					normalEnabled = false;
+	bool					colorEnabled = false;
+	int32_t					numTexLayers = 0;
+
+	std::vector<Position>	positions;
+	std::vector<Vector>		normals;
+	std::vector<Color>		colors;
+	std::vector<TexCoord>	texCoords;
+
+	std::vector<int32_t>	triangles;
+	std::vector<int32_t>	lines;
+	std::vector<int32_t>	particles;
+
+	// custom attributes added before allocVBO(), with their buffers
+	struct CustomAttribute
+	{
+		std::string				name;
+		int32_t					numComponents;
+		AttribType				type;
+		std::vector<float>		floats;
+		std::vector<int32_t>	ints;
+	};
+
+	std::vector<CustomAttribute>	customAttributes;
+
+	VBOBufferMode			mode = VBOBufferMode::Static;
+	bool					complete = false;
+};
+
+// Records the parameters a plugin declares, with their defaults
+class MockParameterManager : public OP_ParameterManager
+{
+public:
+
+	virtual OP_ParAppendResult	appendFloat(const OP_NumericParameter& np, int32_t size = 1) override;
+	virtual OP_ParAppendResult	appendInt(const OP_NumericParameter& np, int32_t size = 1) override;
+	virtual OP_ParAppendResult	appendXY(const OP_NumericParameter& np) override;
+	virtual OP_ParAppendResult	appendXYZ(const OP_NumericParameter& np) override;
+	virtual OP_ParAppendResult	appendUV(const OP_NumericParameter& np) override;
+	virtual OP_ParAppendResult	appendUVW(const OP_NumericParameter& np) override;
+	virtual OP_ParAppendResult	appendRGB(const OP_NumericParameter& np) override;
+	virtual OP_ParAppendResult	appendRGBA(const OP_NumericParameter& np) override;
+	virtual OP_ParAppendResult	appendToggle(const OP_NumericParameter& np) override;
+	virtual OP_ParAppendResult	appendPulse(const OP_NumericParameter& np) override;
+	virtual OP_ParAppendResult	appendMomentary(const OP_NumericParameter& np) override;
+	virtual OP_ParAppendResult	appendWH(const OP_NumericParameter& np) override;
+
+	virtual OP_ParAppendResult	appendString(const OP_StringParameter& sp) override;
+	virtual OP_ParAppendResult	appendFile(const OP_StringParameter& sp) override;
+	virtual OP_ParAppendResult	appendFolder(const OP_StringParameter& sp) override;
+	virtual OP_ParAppendResult	appendDAT(const OP_StringParameter& sp) override;
+	virtual OP_ParAppendResult	appendCHOP(const OP_StringParameter& sp) override;
+	virtual OP_ParAppendResult	appendTOP(const OP_StringParameter& sp) override;
+	virtual OP_ParAppendResult	appendObject(const OP_StringParameter& sp) override;
+	virtual OP_ParAppendResult	appendSOP(const OP_StringParameter& sp) override;
+	virtual OP_ParAppendResult	appendPython(const OP_StringParameter& sp) override;
+	virtual OP_ParAppendResult	appendOP(const OP_StringParameter& sp) override;
+	virtual OP_ParAppendResult	appendCOMP(const OP_StringParameter& sp) override;
+	virtual OP_ParAppendResult	appendMAT(const OP_StringParameter& sp) override;
+	virtual OP_ParAppendResult	appendPanelCOMP(const OP_StringParameter& sp) override;
+	virtual OP_ParAppendResult	appendHeader(const OP_StringParameter& sp) override;
+
+	virtual OP_ParAppendResult	appendMenu(const OP_StringParameter& sp, int32_t nItems,
+									const char** names, const char** labels) override;
+	virtual OP_ParAppendResult	appendStringMenu(const OP_StringParameter& sp, int32_t nItems,
+									const char** names, const char** labels) override;
+
+	// Copies the defaults into 'inputs'
+	void		applyDefaults(MockInputs& inputs) const;
+
+	// Sets parameter 'name' from text the way a user would type it: a number,
+	// a menu item name or a string. Returns false for an unknown parameter.
+	bool		set(MockInputs& inputs, const std::string& name, const std::string& value) const;
+
+private:
+
+	OP_ParAppendResult	appendNumeric(const OP_NumericParameter& np);
+	OP_ParAppendResult	appendText(const OP_StringParameter& sp);
+
+	std::map<std::string, double>		myDefaults;
+	std::map<std::string, std::string>	myStringDefaults;
+	std::map<std::string, std::vector<std::string>>	myMenus;
+};
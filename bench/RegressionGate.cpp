@@ -0,0 +1,276 @@
+#include "RegressionGate.h"
+#include "Json.h"
+
+#include <fstream>
+#include <sstream>
+#include <stdio.h>
+#include <string>
+
+namespace
+{
+	struct BaselineResult
+	{
+		double		p50MinMs = 0.0;
+		double		peakBytes = 0.0;
+	};
+
+	double
+	memberNumber(const JsonValue* object, const char* name, double fallback)
+	{
+		const JsonValue* member = object ? object->find(name) : nullptr;
+
+		if (!member || member->type != JsonValue::Type::Number)
+			return fallback;
+
+		return member->number;
+	}
+
+	// What the baseline was run with against 'config', a line per difference.
+	// A baseline without some of it is from before it was recorded.
+	std::vector<std::string>
+	configDifferences(const JsonValue& baseline, const BenchConfig& config)
+	{
+		std::vector<std::string> differences;
+
+		const JsonValue* mode = baseline.find("mode");
+		const char* runMode = config.vbo ? "executeVBO" : "execute";
+
+		if (!mode || mode->type != JsonValue::Type::String || mode->string != runMode)
+			differences.push_back(std::string("mode: ") + (mode ? mode->string : "?") + " -> " + runMode);
+
+		const JsonValue* changing = baseline.find("changing");
+
+		if (!changing || changing->type != JsonValue::Type::Bool || changing->boolean != config.changing)
+			differences.push_back(std::string("changing input: ") + (config.changing ? "no -> yes" : "yes -> no"));
+
+		const JsonValue* async = baseline.find("async");
+		bool runAsync = BenchRunner::isAsync(config);
+
+		if (!async || async->type != JsonValue::Type::Bool || async->boolean != runAsync)
+			differences.push_back(std::string("Async: ") + (runAsync ? "off -> on" : "on -> off"));
+
+		if (memberNumber(&baseline, "seed", -1.0) != config.seed)
+			differences.push_back("seed: " + std::to_string(static_cast<int64_t>(memberNumber(&baseline, "seed", -1.0))) +
+			                      " -> " + std::to_string(config.seed));
+
+		// parameters in any order, the last value of a repeated one counts
+		std::map<std::string, std::string> basePars;
+		std::map<std::string, std::string> runPars;
+
+		const JsonValue* parameters = baseline.find("parameters");
+
+		if (parameters && parameters->type == JsonValue::Type::Object)
+		{
+			for (const auto& member : parameters->members)
+			{
+				basePars[member.first] = member.second.string;
+			}
+		}
+
+		// Async is compared above
+		basePars.erase("Async");
+
+		for (const auto& par : config.pars)
+		{
+			if (par.first != "Async")
+				runPars[par.first] = par.second;
+		}
+
+		for (const auto& par : runPars)
+		{
+			auto it = basePars.find(par.first);
+
+			if (it == basePars.end())
+				differences.push_back(par.first + ": default -> " + par.second);
+			else if (it->second != par.second)
+				differences.push_back(par.first + ": " + it->second + " -> " + par.second);
+		}
+
+		for (const auto& par : basePars)
+		{
+			if (!runPars.count(par.first))
+				differences.push_back(par.first + ": " + par.second + " -> default");
+		}
+
+		return differences;
+	}
+
+	// Reads the baseline and checks that it was run like 'config'
+	bool
+	loadBaseline(const std::string& baselinePath, const BenchConfig& config, JsonValue& baseline,
+				std::string& error)
+	{
+		std::ifstream file(baselinePath);
+
+		if (!file)
+		{
+			error = "could not read the baseline " + baselinePath;
+			return false;
+		}
+
+		std::stringstream text;
+		text << file.rdbuf();
+
+		if (!Json::parse(text.str(), baseline, error))
+		{
+			error = baselinePath + ": " + error;
+			return false;
+		}
+
+		// timings of another mode or other parameters say nothing about a regression
+		std::vector<std::string> differences = configDifferences(baseline, config);
+
+		if (!differences.empty())
+		{
+			error = baselinePath + " was run with another config, record it again:";
+
+			for (const std::string& difference : differences)
+			{
+				error += "\n  " + difference;
+			}
+
+			return false;
+		}
+
+		return true;
+	}
+
+	double
+	percentChange(double base, double value)
+	{
+		return base > 0.0 ? (value - base) / base * 100.0 : 0.0;
+	}
+}
+
+double
+GateTolerances::getLatencyPercent(const std::string& dataset) const
+{
+	auto it = datasetLatencyPercent.find(dataset);
+	return it != datasetLatencyPercent.end() ? it->second : latencyPercent;
+}
+
+double
+GateTolerances::getMemoryPercent(const std::string& dataset) const
+{
+	auto it = datasetMemoryPercent.find(dataset);
+	return it != datasetMemoryPercent.end() ? it->second : memoryPercent;
+}
+
+bool
+RegressionGate::checkConfig(const std::string& baselinePath, const BenchConfig& config,
+							std::string& error)
+{
+	JsonValue baseline;
+	return loadBaseline(baselinePath, config, baseline, error);
+}
+
+int32_t
+RegressionGate::compare(const std::string& baselinePath, const BenchConfig& config,
+						const std::vector<BenchRun>& runs, const GateTolerances& tolerances,
+						std::string& error)
+{
+	JsonValue baseline;
+
+	if (!loadBaseline(baselinePath, config, baseline, error))
+		return -1;
+
+	const JsonValue* results = baseline.find("results");
+
+	if (!results || results->type != JsonValue::Type::Array)
+	{
+		error = baselinePath + " has no results";
+		return -1;
+	}
+
+	// baseline results by dataset and size
+	std::map<std::pair<std::string, int32_t>, BaselineResult> baseResults;
+
+	for (const JsonValue& result : results->items)
+	{
+		const JsonValue* dataset = result.find("dataset");
+
+		if (!dataset || dataset->type != JsonValue::Type::String)
+			continue;
+
+		const JsonValue* latency = result.find("latency_ms");
+
+		BaselineResult base;
+		base.p50MinMs = memberNumber(latency, "p50_min", memberNumber(latency, "p50", 0.0));
+		base.peakBytes = memberNumber(&result, "peak_bytes", 0.0);
+
+		int32_t numPoints = static_cast<int32_t>(memberNumber(&result, "points", 0.0));
+		baseResults[std::make_pair(dataset->string, numPoints)] = base;
+	}
+
+	printf("\nregression check against %s\n\n", baselinePath.c_str());
+	printf("%-12s %10s %12s %12s %8s %12s %12s %8s\n", "dataset", "points", "base_p50_ms",
+	       "p50_ms", "change", "base_peak_mb", "peak_mb", "change");
+
+	std::vector<std::string> failures;
+
+	for (const BenchRun& run : runs)
+	{
+		std::string dataset = run.dataset->name;
+		auto it = baseResults.find(std::make_pair(dataset, run.numPoints));
+
+		if (it == baseResults.end())
+		{
+			printf("%-12s %10d   not in the baseline\n", dataset.c_str(), run.numPoints);
+			continue;
+		}
+
+		const BaselineResult& base = it->second;
+
+		// the fastest repetition is compared, noise only makes runs slower
+		double latency = run.result.p50MinMs;
+		double latencyChange = percentChange(base.p50MinMs, latency);
+		double latencyTolerance = tolerances.getLatencyPercent(dataset);
+
+		double peak = static_cast<double>(run.result.peakBytes);
+		double peakChange = percentChange(base.peakBytes, peak);
+		double peakTolerance = tolerances.getMemoryPercent(dataset);
+
+		bool slower = latencyChange > latencyTolerance &&
+		              latency - base.p50MinMs > tolerances.latencyFloorMs;
+		bool bigger = peakChange > peakTolerance &&
+		              peak - base.peakBytes > tolerances.memoryFloorBytes;
+
+		printf("%-12s %10d %12.3f %12.3f %+7.1f%%%s %12.2f %12.2f %+7.1f%%%s\n", dataset.c_str(),
+		       run.numPoints, base.p50MinMs, latency, latencyChange, slower ? "!" : " ",
+		       base.peakBytes / 1048576.0, peak / 1048576.0, peakChange, bigger ? "!" : " ");
+
+		char line[256];
+
+		if (slower)
+		{
+			snprintf(line, sizeof(line), "%s %d points: cook p50 %.3f ms -> %.3f ms (%+.1f%%, tolerance %.1f%%)",
+			         dataset.c_str(), run.numPoints, base.p50MinMs, latency, latencyChange, latencyTolerance);
+			failures.push_back(line);
+		}
+
+		if (bigger)
+		{
+			snprintf(line, sizeof(line), "%s %d points: peak memory %.2f MB -> %.2f MB (%+.1f%%, tolerance %.1f%%)",
+			         dataset.c_str(), run.numPoints, base.peakBytes / 1048576.0, peak / 1048576.0,
+			         peakChange, peakTolerance);
+			failures.push_back(line);
+		}
+	}
+
+	if (failures.empty())
+	{
+		printf("\nPASSED: no run regressed beyond its tolerance\n");
+	}
+	else
+	{
+		printf("\nFAILED: %d regression%s\n", static_cast<int32_t>(failures.size()),
+		       failures.size() == 1 ? "" : "s");
+
+		for (const std::string& failure : failures)
+		{
+			printf("  %s\n", failure.c_str());
+		}
+	}
+
+	return static_cast<int32_t>(failures.size());
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "BenchRunner.h"
+#include <map>
+#include <string>
+#include <vector>
+
+// Compares benchmark runs with a baseline written by --json, and fails when
+// a run got slower or uses more memory than its dataset allows
+
+struct GateTolerances
+{
+	// percent a run may get slower or grow before it fails, by default and
+	// per dataset
+	double							latencyPercent = 10.0;
+	double							memoryPercent = 5.0;
+	std::map<std::string, double>	datasetLatencyPercent;
+	std::map<std::string, double>	datasetMemoryPercent;
+
+	// smaller differences are timer and allocator noise, never regressions
+	double							latencyFloorMs = 0.05;
+	double							memoryFloorBytes = 64.0 * 1024.0;
+
+	double		getLatencyPercent(const std::string& dataset) const;
+	double		getMemoryPercent(const std::string& dataset) const;
+};
+
+namespace RegressionGate
+{
+	// Returns false, with the reason in 'error', if the baseline can't be read
+	// or was run with another mode, seed, Async or parameters than 'config'.
+	// Lets a run fail before the benchmark instead of after it.
+	bool		checkConfig(const std::string& baselinePath, const BenchConfig& config,
+					std::string& error);
+
+	// Prints a report of 'runs', made with 'config', against the results in
+	// the JSON file 'baselinePath'. Returns the number of regressions, or -1
+	// with the reason in 'error' if checkConfig() fails.
+	int32_t		compare(const std::string& baselinePath, const BenchConfig& config,
+					const std::vector<BenchRun>& runs, const GateTolerances& tolerances,
+					std::string& error);
+}
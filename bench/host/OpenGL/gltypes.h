@@ -0,0 +1,16 @@
+#pragma once
+
+// Stand-in for the macOS header CPlusPlus_Common.h includes on every
+// platform other than Windows, so the plugin compiles on Linux for the
+// benchmark. Only the types the plugin headers use are here.
+#include <stddef.h>
+#include <stdint.h>
+
+typedef unsigned int	GLuint;
+typedef unsigned int	GLenum;
+typedef int				GLint;
+
+// the plugin entry points are declared __cdecl, which only means something to MSVC
+#ifndef __cdecl
+	#define __cdecl
+#endif